@@ -39,6 +39,7 @@
 #include <asterisk/time.h>
 #include <asterisk/cli.h>
 #include <asterisk/version.h>
+#include <asterisk/linkedlists.h>
 
 #ifndef AST_FORMAT_AMRNB
 #define AST_FORMAT_AMRNB 	(1 << 13)
@@ -50,6 +51,10 @@
 #define DEFAULT_BOARDCODEC "both"
 static char *config = "h324m.conf";
 static char boardcodec[20] = DEFAULT_BOARDCODEC;
+static int muxpolicy = MUXPOLICY_FILLRATIO;
+static int reversebits = 1;
+
+#define MAX_FRAMES      32
 
 #define PKT_PAYLOAD     1450
 #define PKT_SIZE        (sizeof(struct ast_frame) + AST_FRIENDLY_OFFSET + PKT_PAYLOAD)
@@ -142,6 +147,24 @@ static char debug_usage[] =
 "        4 - Debug messages\n"
 "        5 - File dumps\n";
 
+static char stats_usage[] =
+"Usage: h324m show stats\n"
+"       Shows the mux, adaptation layer and control counters of the\n"
+"       running H.324M sessions\n";
+
+/* Counters of a running session, copied by its call thread */
+struct h324m_call
+{
+	char		name[80];
+	struct timeval	start;
+	struct timeval	updated;
+	int		state;
+	H324MStats	stats;
+	AST_LIST_ENTRY(h324m_call) list;
+};
+
+static AST_LIST_HEAD_STATIC(calls, h324m_call);
+
 /* Configuration file */
 static int load_config(void)
 {
@@ -221,13 +244,36 @@ static int load_config(void)
       {
           ast_verbose(VERBOSE_PREFIX_3 "H245 reverse bits : %s\n",
                         (reverse == 0)?"no":"yes");
-          H324MSetReverseBits(reverse);
+          reversebits = reverse;
       }
       else
       {
           ast_log(LOG_WARNING, "Invalid reverse bit flag %s. Bits will be reversed.\n", tmp);
       }
    }
+   /* Default, also on reload if it's removed or wrong */
+   muxpolicy = MUXPOLICY_FILLRATIO;
+   tmp = (void *)ast_variable_retrieve(cfg, "h245", "muxpolicy");
+   if (tmp)
+   {
+      if (!strcmp(tmp, "fillratio"))
+      {
+          muxpolicy = MUXPOLICY_FILLRATIO;
+          ast_verbose(VERBOSE_PREFIX_3 "H245 mux policy : %s\n", tmp);
+      }
+      else if (!strcmp(tmp, "audiofirst"))
+      {
+          muxpolicy = MUXPOLICY_AUDIOFIRST;
+          ast_verbose(VERBOSE_PREFIX_3 "H245 mux policy : %s\n", tmp);
+      }
+      else if (!strcmp(tmp, "throughput"))
+      {
+          muxpolicy = MUXPOLICY_THROUGHPUT;
+          ast_verbose(VERBOSE_PREFIX_3 "H245 mux policy : %s\n", tmp);
+      }
+      else
+          ast_log(LOG_WARNING, "Invalid mux policy %s. Using fillratio.\n", tmp);
+   }
    ast_config_destroy(cfg);
 
   if (level > 0)
@@ -240,6 +286,101 @@ static int load_config(void)
 }
 
 
+static struct h324m_call* h324m_call_add(struct ast_channel *chan)
+{
+	/* Create call */
+	struct h324m_call *call = (struct h324m_call *) calloc(1, sizeof(struct h324m_call));
+
+	/* Check */
+	if (!call)
+		return NULL;
+
+	/* Set name and time */
+	ast_copy_string(call->name, chan->name, sizeof(call->name));
+	call->start = ast_tvnow();
+
+	/* Append it */
+	AST_LIST_LOCK(&calls);
+	AST_LIST_INSERT_TAIL(&calls, call, list);
+	AST_LIST_UNLOCK(&calls);
+
+	return call;
+}
+
+static void h324m_call_update(struct h324m_call *call, void *id)
+{
+	H324MStats stats;
+	struct timeval now = ast_tvnow();
+
+	/* Only once per second, the session must only be read from its thread */
+	if (!call || ast_tvdiff_ms(now, call->updated) < 1000)
+		return;
+
+	/* Get counters */
+	H324MSessionGetStats(id, &stats);
+
+	/* Copy them */
+	AST_LIST_LOCK(&calls);
+	call->stats = stats;
+	call->state = H324MSessionGetState(id);
+	call->updated = now;
+	AST_LIST_UNLOCK(&calls);
+}
+
+static void h324m_call_remove(struct h324m_call *call)
+{
+	/* Check */
+	if (!call)
+		return;
+
+	/* Remove it */
+	AST_LIST_LOCK(&calls);
+	AST_LIST_REMOVE(&calls, call, list);
+	AST_LIST_UNLOCK(&calls);
+
+	/* Free */
+	free(call);
+}
+
+static void h324m_show_stats(int fd)
+{
+	static char *names[] = { "audio", "video", "control" };
+	struct h324m_call *call;
+	int i, num = 0;
+
+	AST_LIST_LOCK(&calls);
+
+	/* For each session */
+	AST_LIST_TRAVERSE(&calls, call, list)
+	{
+		H324MStats *s = &call->stats;
+
+		/* Session counters */
+		ast_cli(fd, "%s state %d for %ds\n", call->name, call->state, (int) (ast_tvdiff_ms(ast_tvnow(), call->start) / 1000));
+		ast_cli(fd, "  mux      bytes %u/%u pdus %u/%u stuffing %u/%u\n",
+			s->bytesIn, s->bytesOut, s->pdusIn, s->pdusOut, s->stuffingIn, s->stuffingOut);
+		ast_cli(fd, "  demux    resyncs %u golay corrected %u failed %u\n",
+			s->resyncs, s->headerCorrected, s->headerErrors);
+		ast_cli(fd, "  srp      commands %u retransmitted %u duplicated %u\n",
+			s->srpCommands, s->srpRetransmissions, s->srpDuplicates);
+
+		/* Logical channels */
+		for (i=0; i<STATS_CHANNELS; i++)
+		{
+			H324MChannelStats *c = &s->channels[i];
+			ast_cli(fd, "  %-8s lc %d/%d bytes %u/%u sdus %u/%u crc %u queued %u max %u dropped %u\n",
+				names[i], c->remoteChannel, c->localChannel, c->bytesIn, c->bytesOut,
+				c->sdusIn, c->sdusOut, c->crcErrors, c->queued, c->maxQueued, c->dropped);
+		}
+
+		num++;
+	}
+
+	AST_LIST_UNLOCK(&calls);
+
+	ast_cli(fd, "%d H.324M sessions (in/out)\n", num);
+}
+
 #if ASTERISK_VERSION_NUM>10600
 static char *h324m_do_debug(struct ast_cli_entry *e, int cmd, struct ast_cli_args *a)
 {
@@ -272,11 +413,11 @@ static char *h324m_do_debug(struct ast_cli_entry *e, int cmd, struct ast_cli_arg
 
 			/* Print result */	
 			if(level)
-				ast_cli(a->fd, "app_h324m Debugging enabled level: %d\n", level);
+				ast_cli(a->fd, "app_h324m Debugging enabled level: %d for new calls\n", level);
 			else
-				ast_cli(a->fd, "app_h324m Debugging disabled\n");
+				ast_cli(a->fd, "app_h324m Debugging disabled for new calls\n");
 
-			/* Set log level */
+			/* Set log level of the new calls */
 			H324MLoggerSetLevel(level);
 
 			return CLI_SUCCESS;
@@ -285,6 +426,32 @@ static char *h324m_do_debug(struct ast_cli_entry *e, int cmd, struct ast_cli_arg
 
 static struct ast_cli_entry  cli_debug = AST_CLI_DEFINE(h324m_do_debug,"Set app_h324m debug log level");
 
+static char *h324m_do_stats(struct ast_cli_entry *e, int cmd, struct ast_cli_args *a)
+{
+	switch (cmd) 
+	{
+		case CLI_INIT:
+			e->command = "h324m show stats";
+			e->usage = stats_usage;
+			return NULL;
+
+		case CLI_GENERATE:
+			return NULL;
+
+		default:
+			/* Check number of arguments */
+			if (a->argc != 3)
+				return CLI_SHOWUSAGE;
+
+			/* Show them */
+			h324m_show_stats(a->fd);
+
+			return CLI_SUCCESS;
+	}
+}
+
+static struct ast_cli_entry  cli_stats = AST_CLI_DEFINE(h324m_do_stats,"Show H.324M session counters");
+
 #else
 /* Commands */
 static int h324m_do_debug(int fd, int argc, char *argv[])
@@ -304,11 +471,11 @@ static int h324m_do_debug(int fd, int argc, char *argv[])
 
 	/* Print result */	
 	if(level)
-		ast_cli(fd, "app_h324m Debugging enabled level: %d\n", level);
+		ast_cli(fd, "app_h324m Debugging enabled level: %d for new calls\n", level);
 	else
-		ast_cli(fd, "app_h324m Debugging disabled\n");
+		ast_cli(fd, "app_h324m Debugging disabled for new calls\n");
 
-	/* Set log level */
+	/* Set log level of the new calls */
 	H324MLoggerSetLevel(level);
 
 	/* Exit */
@@ -339,6 +506,22 @@ static struct ast_cli_entry cli_reload = {
   "Reload h324m stack configuration", usage_reload, NULL
 };
 
+/* Show session counters */
+static int h324m_do_stats(int fd, int argc, char **argv)
+{
+	/* Check number of arguments */
+	if (argc != 3)
+		return RESULT_SHOWUSAGE;
+
+	/* Show them */
+	h324m_show_stats(fd);
+
+	return RESULT_SUCCESS;
+}
+
+static struct ast_cli_entry cli_stats =
+	{ { "h324m", "show", "stats" }, h324m_do_stats, "Show H.324M session counters", stats_usage };
+
 #endif
 
 /*
@@ -493,13 +676,10 @@ static struct ast_frame* create_ast_frame(void *frame, struct video_creator *vt)
 			data[0] = 0xF0;
 			/* Increase pointer to match frame */
 			data++;
-			/* Copy */
-			memcpy(data, framedata, framelength);
-			
 			/*Convert IF2 into AMR MIME format*/
 
-			/*Reverse bytes*/
-			TIFFReverseBits(data, framelength);
+			/*Copy reversing bytes*/
+			TIFFReverseBitsCopy(data, framedata, framelength);
 
 			/*If amr has a byte more than if2 */
 			if(stuf < 4)
@@ -830,12 +1010,12 @@ static void* create_h324m_frame(struct h324m_packetizer *pak,struct ast_frame* f
 			pak->offset[0] |= mode;
 			/* Inc offset first */
 			pak->offset += bs;
-			/* Create frame */	
-			return FrameCreate(MEDIA_AUDIO, CODEC_AMR, pak->offset - bs, bs);
+			/* Create frame without copying, it's destroyed before the ast_frame */	
+			return FrameCreateView(MEDIA_AUDIO, CODEC_AMR, pak->offset - bs, bs, NULL, NULL);
 		case AST_FRAME_VIDEO:
-			/* Create frame */
-			return FrameCreate(MEDIA_VIDEO, CODEC_H263,
-pak->framedata, pak->framelength); default:
+			/* Create frame without copying, it's destroyed before the ast_frame */
+			return FrameCreateView(MEDIA_VIDEO, CODEC_H263,
+pak->framedata, pak->framelength, NULL, NULL); default:
 			break;
 	}
 	/* NOthing */
@@ -845,8 +1025,11 @@ pak->framedata, pak->framelength); default:
 static int app_h324m_loopback(struct ast_channel *chan, void *data)
 {
 	struct ast_frame *f;
+	struct h324m_call *call;
 	struct ast_module_user *u;
-	void*  frame;
+	void*  frames[MAX_FRAMES];
+	void*  back[MAX_FRAMES];
+	int    i, num;
 	int loop_audio=1, loop_video=1;
 
 	ast_log(LOG_DEBUG, "h324m_loopback\n");
@@ -867,9 +1050,18 @@ static int app_h324m_loopback(struct ast_channel *chan, void *data)
 	/* Create session */
 	void* id = H324MSessionCreate();
 
+	/* Set mux policy */
+	H324MSessionSetMuxPolicy(id, muxpolicy);
+
+	/* Set bit order */
+	H324MSessionSetReverseBits(id, reversebits);
+
 	/* Init session */
 	H324MSessionInit(id);
 
+	/* Show it in the cli */
+	call = h324m_call_add(chan);
+
 	/* Wait for data avaiable on channel */
 	while (ast_waitfor(chan, -1) > -1) 
 	{
@@ -885,24 +1077,35 @@ static int app_h324m_loopback(struct ast_channel *chan, void *data)
 		{
 			/* read data */
 			H324MSessionRead(id, AST_FRAME_GET_BUFFER(f), f->datalen);
+			/* Update counters */
+			h324m_call_update(call, id);
 			/* Get frames */
-			while ((frame=H324MSessionGetFrame(id))!=NULL)
+			while ((num=H324MSessionGetFrames(id,frames,MAX_FRAMES))>0)
 			{
-				if (FrameGetType(frame)==MEDIA_VIDEO) 
+				/* Frames to send back */
+				int loop = 0;
+				/* For each one */
+				for (i=0;i<num;i++)
 				{
-					/* If video loopback is activated */
-					if (loop_video) 
-						/* Send it back */
-						H324MSessionSendFrame(id,frame);
-
-				} else if (FrameGetType(frame)==MEDIA_AUDIO) {
-					/* If audio loopback is activated */
-					if (loop_audio)
-						/* Send it back. Note: this can cause loopback/echo problems */
-						H324MSessionSendFrame(id,frame);
+					if (FrameGetType(frames[i])==MEDIA_VIDEO) 
+					{
+						/* If video loopback is activated */
+						if (loop_video) 
+							/* Send it back */
+							back[loop++] = frames[i];
+
+					} else if (FrameGetType(frames[i])==MEDIA_AUDIO) {
+						/* If audio loopback is activated */
+						if (loop_audio)
+							/* Send it back. Note: this can cause loopback/echo problems */
+							back[loop++] = frames[i];
+					}
 				}
-				/* Delete frame */
-				FrameDestroy(frame);
+				/* Send them back all together */
+				if (loop)
+					H324MSessionSendFrames(id,back,loop);
+				/* Delete frames */
+				FramesDestroy(frames,num);
 			}
 			/* write data */
 			H324MSessionWrite(id, AST_FRAME_GET_BUFFER(f), f->datalen);
@@ -914,6 +1117,9 @@ static int app_h324m_loopback(struct ast_channel *chan, void *data)
 		} 
 	}
 
+	/* Remove it from the cli */
+	h324m_call_remove(call);
+
 	/* Destroy session */
 	H324MSessionEnd(id);
 
@@ -932,11 +1138,14 @@ static int app_h324m_loopback(struct ast_channel *chan, void *data)
 static int app_h324m_gw(struct ast_channel *chan, void *data)
 {
 	struct ast_frame *f;
+	struct h324m_call *call;
 	struct ast_frame *send;
 	struct ast_module_user *u;
 	struct h324m_packetizer pak;
 	struct video_creator vt;
 	void*  frame;
+	void*  frames[MAX_FRAMES];
+	int    i, num;
 	char*  input;
 	char*  src = 0;
 	int    reason = 0;
@@ -1059,9 +1268,18 @@ static int app_h324m_gw(struct ast_channel *chan, void *data)
 	/* Create session */
 	void* id = H324MSessionCreate();
 
+	/* Set mux policy */
+	H324MSessionSetMuxPolicy(id, muxpolicy);
+
+	/* Set bit order */
+	H324MSessionSetReverseBits(id, reversebits);
+
 	/* Init session */
 	H324MSessionInit(id);
 
+	/* Show it in the cli */
+	call = h324m_call_add(chan);
+
 	/* Answer call */
 	ast_answer(chan);
 
@@ -1083,6 +1301,8 @@ static int app_h324m_gw(struct ast_channel *chan, void *data)
 			{
 				/* read data */
 				H324MSessionRead(id, AST_FRAME_GET_BUFFER(f), f->datalen);
+				/* Update counters */
+				h324m_call_update(call, id);
 				/* If state changed */
 				if (state!=H324MSessionGetState(id))
 				{
@@ -1099,17 +1319,24 @@ static int app_h324m_gw(struct ast_channel *chan, void *data)
 						ast_log(LOG_DEBUG, "Connected, sending VIDUPDATE\n");
 						/* Indicate Video Update */
 						ast_indicate(pseudo, AST_CONTROL_VIDUPDATE);
+					} else if (state==CALLSTATE_HANGUP) {
+						/* Log */
+						ast_log(LOG_WARNING, "H324M negotiation timed out, hanging up\n");
+						/* exit */
+						reason = AST_CAUSE_RECOVERY_ON_TIMER_EXPIRE;
 					}
 				}
 				/* Get frames */
-				while ((frame=H324MSessionGetFrame(id))!=NULL)
+				while ((num=H324MSessionGetFrames(id,frames,MAX_FRAMES))>0)
 				{
-					/* Packetize outgoing frame */
-					if ((send=create_ast_frame(frame,&vt))!=NULL)
-						/* Send frame */
-						ast_write(pseudo,send);
-					/* Delete frame */
-					FrameDestroy(frame);
+					/* For each one */
+					for (i=0;i<num;i++)
+						/* Packetize outgoing frame */
+						if ((send=create_ast_frame(frames[i],&vt))!=NULL)
+							/* Send frame */
+							ast_write(pseudo,send);
+					/* Delete frames */
+					FramesDestroy(frames,num);
 				}
 				/* Get user input */
 				while((input=H324MSessionGetUserInput(id))!=NULL)
@@ -1202,6 +1429,9 @@ static int app_h324m_gw(struct ast_channel *chan, void *data)
 		}
 	}
 
+	/* Remove it from the cli */
+	h324m_call_remove(call);
+
 	/* End session */
 	H324MSessionEnd(id);
 
@@ -1234,11 +1464,14 @@ end:
 static int app_h324m_call(struct ast_channel *chan, void *data)
 {
 	struct ast_frame *f;
+	struct h324m_call *call;
 	struct ast_frame *send;
 	struct ast_module_user *u;
 	struct h324m_packetizer pak;
 	struct video_creator vt;
 	void*  frame;
+	void*  frames[MAX_FRAMES];
+	int    i, num;
 	char*  input;
 	int    reason = 0;
 	int    state = 0;
@@ -1392,9 +1625,18 @@ static int app_h324m_call(struct ast_channel *chan, void *data)
 	/* Create session */
 	void* id = H324MSessionCreate();
 
+	/* Set mux policy */
+	H324MSessionSetMuxPolicy(id, muxpolicy);
+
+	/* Set bit order */
+	H324MSessionSetReverseBits(id, reversebits);
+
 	/* Init session */
 	H324MSessionInit(id);
 
+	/* Show it in the cli */
+	call = h324m_call_add(chan);
+
 	/* Wait for data avaiable on any channel */
 	while (!reason && (where = ast_waitfor_n(channels, 2, &ms)) != NULL) 
 	{
@@ -1413,6 +1655,8 @@ static int app_h324m_call(struct ast_channel *chan, void *data)
 			{
 				/* read data */
 				H324MSessionRead(id, AST_FRAME_GET_BUFFER(f), f->datalen);
+				/* Update counters */
+				h324m_call_update(call, id);
 
 				/* If state changed */
 				if (state!=H324MSessionGetState(id))
@@ -1432,17 +1676,24 @@ static int app_h324m_call(struct ast_channel *chan, void *data)
 						ast_log(LOG_DEBUG, "Connected, sending VIDUPDATE\n");
 						/* Indicate Video Update */
 						ast_indicate(pseudo, AST_CONTROL_VIDUPDATE);
+					} else if (state==CALLSTATE_HANGUP) {
+						/* Log */
+						ast_log(LOG_WARNING, "H324M negotiation timed out, hanging up\n");
+						/* exit */
+						reason = AST_CAUSE_RECOVERY_ON_TIMER_EXPIRE;
 					}
 				}
 				/* Get frames */
-				while ((frame=H324MSessionGetFrame(id))!=NULL)
+				while ((num=H324MSessionGetFrames(id,frames,MAX_FRAMES))>0)
 				{
-					/* Packetize outgoing frame */
-					if ((send=create_ast_frame(frame,&vt))!=NULL)
-						/* Send frame */
-						ast_write(chan,send);
-					/* Delete frame */
-					FrameDestroy(frame);
+					/* For each one */
+					for (i=0;i<num;i++)
+						/* Packetize outgoing frame */
+						if ((send=create_ast_frame(frames[i],&vt))!=NULL)
+							/* Send frame */
+							ast_write(chan,send);
+					/* Delete frames */
+					FramesDestroy(frames,num);
 				}
 				/* Get user input */
 				while((input=H324MSessionGetUserInput(id))!=NULL)
@@ -1501,6 +1752,9 @@ static int app_h324m_call(struct ast_channel *chan, void *data)
 		}
 	}
 
+	/* Remove it from the cli */
+	h324m_call_remove(call);
+
 	/* End session */
 	H324MSessionEnd(id);
 
@@ -1645,6 +1899,7 @@ static int unload_module(void)
 
         ast_cli_unregister(&cli_debug);
 	ast_cli_unregister(&cli_reload);
+	ast_cli_unregister(&cli_stats);
 
 	res = ast_unregister_application(name_h324m_loopback);
 	res &= ast_unregister_application(name_h324m_gw);
@@ -1683,6 +1938,7 @@ static int load_module(void)
 
 	ast_cli_register(&cli_debug);
 	ast_cli_register(&cli_reload);
+	ast_cli_register(&cli_stats);
 
 	/* No loging by default */
 	H324MLoggerSetLevel(1);
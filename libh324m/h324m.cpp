@@ -1,11 +1,8 @@
-extern "C" 
-{
-#include "bits.c"
-}
-
 #include "src/H324MSession.h"
+#include "src/H324MEngine.h"
 
-static bool _reverseBits = true;
+//Bit order of new sessions, only changed by the deprecated H324MSetReverseBits
+static volatile int _reverseBits = true;
 
 extern "C" 
 {
@@ -17,7 +14,7 @@ void H324MLoggerSetLevel(int level)
 
 void H324MSetReverseBits(int reverse)
 {
-        _reverseBits = (bool) reverse;
+	_reverseBits = reverse;
 }
 
 void H324MLoggerSetCallback(int (*callback)  (const char *, va_list))
@@ -27,7 +24,13 @@ void H324MLoggerSetCallback(int (*callback)  (const char *, va_list))
 
 void * H324MSessionCreate()
 {
-	return (void *)new H324MSession(); 
+	H324MSession *session = new H324MSession();
+
+	//If the default was changed
+	if (!_reverseBits)
+		session->SetReverseBits(false);
+
+	return (void *)session; 
 }	
 
 void H324MSessionDestroy(void * id)
@@ -52,15 +55,12 @@ int  H324MSessionEnd(void * id)
 
 int  H324MSessionRead(void * id,unsigned char *buffer,int len)
 { 
-	if (_reverseBits) TIFFReverseBits(buffer,len);
 	return ((H324MSession*)id)->Read(buffer,len); 
 }
 
 int  H324MSessionWrite(void * id,unsigned char *buffer,int len)
 { 	
-	int ret = ((H324MSession*)id)->Write(buffer,len); 
-	if (_reverseBits) TIFFReverseBits(buffer,len);
-	return ret;
+	return ((H324MSession*)id)->Write(buffer,len); 
 }
 
 void * H324MSessionGetFrame(void * id)
@@ -68,6 +68,20 @@ void * H324MSessionGetFrame(void * id)
 	return (void *)((H324MSession*)id)->GetFrame();
 }
 
+int  H324MSessionGetFrames(void * id,void **frames,int max)
+{
+	if (max<=0)
+		return 0;
+	return ((H324MSession*)id)->GetFrames((Frame**)frames,max);
+}
+
+int  H324MSessionSendFrames(void * id,void **frames,int num)
+{
+	if (num<=0)
+		return 0;
+	return ((H324MSession*)id)->SendFrames((Frame**)frames,num);
+}
+
 int  H324MSessionSendFrame(void * id,void *frame)
 { 	
 	return ((H324MSession*)id)->SendFrame((Frame*)frame);
@@ -93,11 +107,58 @@ int  H324MSessionGetState(void * id)
 	return ((H324MSession*)id)->GetState();
 }
 
+int  H324MSessionSetMuxPolicy(void * id,int policy)
+{ 	
+	return ((H324MSession*)id)->SetMuxPolicy(policy);
+}
+
+int  H324MSessionSetReverseBits(void * id,int reverse)
+{ 	
+	return ((H324MSession*)id)->SetReverseBits(reverse);
+}
+
+int  H324MSessionSetControlRetransmission(void * id,int t401,int n400,int window)
+{ 	
+	return ((H324MSession*)id)->SetControlRetransmission(t401,n400,window);
+}
+
+int  H324MSessionGetStats(void * id,H324MStats *stats)
+{
+	return ((H324MSession*)id)->GetStats(stats);
+}
+
+int  H324MSessionSetTimeout(void * id,int timer,int ms)
+{ 	
+	return ((H324MSession*)id)->SetTimeout(timer,ms);
+}
+
+int  H324MSessionTick(void * id,int ms)
+{ 	
+	if (ms<0)
+		return 0;
+	return ((H324MSession*)id)->Tick(ms);
+}
+
+int  H324MSessionSetTrace(void * id,int enabled)
+{ 	
+	return ((H324MSession*)id)->SetTrace(enabled);
+}
+
+int  H324MSessionSetLogger(void * id,int level,int (*callback)  (const char *, va_list))
+{ 	
+	return ((H324MSession*)id)->SetLogger(level,callback);
+}
+
 void * FrameCreate(int type, int codec, unsigned char * data, int len)
 {
 	return (void*)new Frame((MediaType)type,(MediaCodec)codec,data,len);
 }
 
+void * FrameCreateView(int type, int codec, unsigned char * data, int len, void (*release)(void *param,unsigned char *data), void *param)
+{
+	return (void*)new Frame((MediaType)type,(MediaCodec)codec,data,len,release,param);
+}
+
 int FrameGetType(void* frame)
 {
 	return ((Frame*)frame)->type;
@@ -123,4 +184,108 @@ void FrameDestroy(void *frame)
 	delete (Frame*)frame;
 }
 
+void FramesDestroy(void **frames,int num)
+{
+	for (int i=0;i<num;i++)
+		delete (Frame*)frames[i];
+}
+
+void * H324MEngineCreate(int workers,int affinity)
+{
+	return (void *)new H324MEngine(workers,affinity);
+}
+
+void H324MEngineDestroy(void * engine)
+{
+	delete ((H324MEngine*)engine);
+}
+
+void * H324MEngineAddSession(void * engine,void * id)
+{
+	return (void *)((H324MEngine*)engine)->AddSession((H324MSession*)id);
+}
+
+void * H324MEngineRemoveSession(void * engine,void * slot)
+{
+	return (void *)((H324MEngine*)engine)->RemoveSession((H324MEngine::Slot*)slot);
+}
+
+int H324MEngineRead(void * engine,void * slot,unsigned char *buffer,int len)
+{
+	return ((H324MEngine*)engine)->Read((H324MEngine::Slot*)slot,buffer,len);
+}
+
+int H324MEngineWrite(void * engine,void * slot,unsigned char *buffer,int len)
+{
+	return ((H324MEngine*)engine)->Write((H324MEngine::Slot*)slot,buffer,len);
+}
+
+int H324MEngineGetFrames(void * engine,void * slot,void **frames,int max)
+{
+	if (max<=0)
+		return 0;
+	return ((H324MEngine*)engine)->GetFrames((H324MEngine::Slot*)slot,(Frame**)frames,max);
+}
+
+int H324MEngineSendFrames(void * engine,void * slot,void **frames,int num)
+{
+	if (num<=0)
+		return 0;
+	return ((H324MEngine*)engine)->SendFrames((H324MEngine::Slot*)slot,(Frame**)frames,num);
+}
+
+int H324MEngineReleaseFrames(void * engine,void * slot,void **frames,int num)
+{
+	if (num<=0)
+		return 0;
+	return ((H324MEngine*)engine)->ReleaseFrames((H324MEngine::Slot*)slot,(Frame**)frames,num);
+}
+
+int H324MEngineGetState(void * engine,void * slot)
+{
+	return ((H324MEngine*)engine)->GetState((H324MEngine::Slot*)slot);
+}
+
+int H324MEngineEnd(void * engine,void * slot)
+{
+	return ((H324MEngine*)engine)->End((H324MEngine::Slot*)slot);
+}
+
+char * H324MEngineGetUserInput(void * engine,void * slot)
+{
+	return ((H324MEngine*)engine)->GetUserInput((H324MEngine::Slot*)slot);
+}
+
+int H324MEngineSendUserInput(void * engine,void * slot,char *input)
+{
+	return ((H324MEngine*)engine)->SendUserInput((H324MEngine::Slot*)slot,input);
+}
+
+int H324MEngineSendVideoFastUpdatePicture(void * engine,void * slot)
+{
+	return ((H324MEngine*)engine)->SendVideoFastUpdatePicture((H324MEngine::Slot*)slot);
+}
+
+int H324MEngineSetTimeout(void * engine,void * slot,int timer,int ms)
+{
+	return ((H324MEngine*)engine)->SetTimeout((H324MEngine::Slot*)slot,timer,ms);
+}
+
+int H324MEngineTick(void * engine,void * slot,int ms)
+{
+	if (ms<0)
+		return 0;
+	return ((H324MEngine*)engine)->Tick((H324MEngine::Slot*)slot,ms);
+}
+
+int H324MEngineSetTrace(void * engine,void * slot,int enabled)
+{
+	return ((H324MEngine*)engine)->SetTrace((H324MEngine::Slot*)slot,enabled);
+}
+
+int H324MEngineGetStats(void * engine,void * slot,H324MStats *stats)
+{
+	return ((H324MEngine*)engine)->GetStats((H324MEngine::Slot*)slot,stats);
+}
+
 }
@@ -14,12 +14,76 @@
 #define CALLSTATE_STABLISHED	3
 #define CALLSTATE_HANGUP	4
 
+#define MUXPOLICY_FILLRATIO	0
+#define MUXPOLICY_AUDIOFIRST	1
+#define MUXPOLICY_THROUGHPUT	2
+
+#define H245_T101	0
+#define H245_T102	1
+#define H245_T103	2
+#define H245_T104	3
+#define H245_T105	4
+#define H245_T106	5
+#define H245_T107	6
+#define H245_T108	7
+#define H245_T109	8
+
+#define STATS_AUDIO	0
+#define STATS_VIDEO	1
+#define STATS_CONTROL	2
+#define STATS_CHANNELS	3
+
+/* Counters of a logical channel, the control one is always channel 0 */
+typedef struct
+{
+	int		localChannel;	/* 0 if not opened yet */
+	int		remoteChannel;
+	unsigned int	bytesIn;	/* payload bytes demuxed for the remote channel */
+	unsigned int	bytesOut;	/* payload bytes muxed for the local channel */
+	unsigned int	sdusIn;		/* AL-SDUs received with good crc */
+	unsigned int	sdusOut;	/* AL-SDUs sent */
+	unsigned int	crcErrors;	/* AL-SDUs received with bad crc */
+	unsigned int	queued;		/* AL-SDUs waiting to be muxed */
+	unsigned int	maxQueued;
+	unsigned int	dropped;	/* AL-SDUs dropped from the send queue */
+} H324MChannelStats;
+
+/* Counters of a session since it was created */
+typedef struct
+{
+	unsigned int	bytesIn;
+	unsigned int	bytesOut;
+	unsigned int	pdusIn;		/* MUX-PDUs with a good header */
+	unsigned int	pdusOut;
+	unsigned int	stuffingIn;	/* stuffing MUX-PDUs */
+	unsigned int	stuffingOut;
+	unsigned int	resyncs;	/* times the flag sync was lost */
+	unsigned int	headerCorrected;/* headers with errors corrected by golay */
+	unsigned int	headerErrors;	/* headers golay couldn't correct */
+	unsigned int	srpCommands;	/* H.245 commands sent */
+	unsigned int	srpRetransmissions;
+	unsigned int	srpDuplicates;	/* commands received again */
+	unsigned int	inputDropped;	/* bearer bytes the engine dropped as they were not demuxed in time */
+	unsigned int	outputDropped;	/* muxed bytes the engine dropped as they were not written in time */
+	H324MChannelStats channels[STATS_CHANNELS];
+} H324MStats;
+
+/* Threading: sessions share no mutable state, so different sessions can be
+ * driven at the same time from different threads without any lock. A session
+ * and the frames it returns must only be used from one thread at a time, as
+ * destroying a received frame gives its buffer back to the session. Each session
+ * has its own log level, callback and bit order, the process wide ones are only
+ * the defaults copied by the sessions created afterwards. The callback is called
+ * from all the threads using sessions. */
 #ifdef __cplusplus
 extern "C"
 {
 #endif
 void 	TIFFReverseBits(unsigned char* buffer,int length);
-void    H324MSetReverseBits(int reverse);
+void 	TIFFReverseBitsCopy(unsigned char* dst,const unsigned char* src,int length);
+/* Deprecated, bit order of the sessions created afterwards, use H324MSessionSetReverseBits */
+void    H324MSetReverseBits(int reverse) __attribute__((deprecated));
+/* Defaults of the sessions created afterwards and of the messages logged outside of them */
 void 	H324MLoggerSetLevel(int level);
 void    H324MLoggerSetCallback(int (*callback)  (const char *, va_list));
 
@@ -33,21 +97,77 @@ int	H324MSessionEnd(void * id);
 int	H324MSessionRead(void * id,unsigned char *buffer,int len);
 int	H324MSessionWrite(void * id,unsigned char *buffer,int len);
 
+/* Received frames share the session buffers but can still be destroyed after the session is */
 void*	H324MSessionGetFrame(void * id);
 int	H324MSessionSendFrame(void * id,void *frame);
+/* Fill frames with up to max received frames, returns how many. Destroy them with FramesDestroy */
+int	H324MSessionGetFrames(void * id,void **frames,int max);
+/* Send num frames, they are still owned by the caller */
+int	H324MSessionSendFrames(void * id,void **frames,int num);
 
 char* 	H324MSessionGetUserInput(void * id);
 int  	H324MSessionSendUserInput(void * id,char *input);
 
 int	H324MSessionSendVideoFastUpdatePicture(void * id);
 int	H324MSessionGetState(void * id);
+int	H324MSessionSetMuxPolicy(void * id,int policy);
+/* Bit order of the bytes read and written, reversed by default */
+int	H324MSessionSetReverseBits(void * id,int reverse);
+/* H.245 retransmission timeout in ms (T401), max retries (N400) and max commands waiting for response */
+int	H324MSessionSetControlRetransmission(void * id,int t401,int n400,int window);
+/* Timeout in ms of a H.245 procedure timer (H245_T101..H245_T109), 10s by default */
+int	H324MSessionSetTimeout(void * id,int timer,int ms);
+/* Advance the H.245 timers ms, once called they are not driven by the written bytes any more */
+int	H324MSessionTick(void * id,int ms);
+int	H324MSessionSetTrace(void * id,int enabled);
+/* Log level and callback (vprintf if NULL) of the session */
+int	H324MSessionSetLogger(void * id,int level,int (*callback)  (const char *, va_list));
+/* Copy the session counters, cheap enough to be called often from the session thread */
+int	H324MSessionGetStats(void * id,H324MStats *stats);
 
 void* 	FrameCreate(int type,int codec, unsigned char * buffer, int len);
+/* Doesn't copy the buffer, release (if not NULL) is called when the frame is destroyed */
+void* 	FrameCreateView(int type,int codec, unsigned char * buffer, int len, void (*release)(void *param,unsigned char *buffer), void *param);
 int 	FrameGetType(void* frame);
 int 	FrameGetCodec(void* frame);
 unsigned char * FrameGetData(void* frame);
 unsigned int 	FrameGetLength(void *frame);
 void 	FrameDestroy(void *frame);
+void 	FramesDestroy(void **frames,int num);
+
+/* Engine running many sessions on a pool of worker threads. 
+ * workers<=0 starts one per cpu, affinity>=0 pins worker i to cpu affinity+i. 
+ * The session must be configured and initialized before adding it, after that it
+ * must only be used with the H324MEngine calls until it's removed. The io calls
+ * don't wait for the session processing: Read queues the input and Write returns
+ * the bytes already muxed, one byte out for each byte in, which could be less than
+ * len. Muxed data not written in time is dropped. The session calls (End, user input,
+ * fast update, timers, trace and stats) and ReleaseFrames wait for the worker to finish its
+ * current pass on the session. */
+void*	H324MEngineCreate(int workers,int affinity);
+void	H324MEngineDestroy(void * engine);
+/* Returns NULL if no worker thread could be started */
+void*	H324MEngineAddSession(void * engine,void * id);
+/* Returns the session id, pending input and frames are discarded */
+void*	H324MEngineRemoveSession(void * engine,void * slot);
+int	H324MEngineRead(void * engine,void * slot,unsigned char *buffer,int len);
+int	H324MEngineWrite(void * engine,void * slot,unsigned char *buffer,int len);
+/* Received frames must be given back with H324MEngineReleaseFrames, not destroyed */
+int	H324MEngineGetFrames(void * engine,void * slot,void **frames,int max);
+/* The engine takes the frames and destroys them once sent. The data of the ones
+ * created with FrameCreateView is copied and they are destroyed before returning.
+ * Received frames can't be sent, the number of frames taken is returned */
+int	H324MEngineSendFrames(void * engine,void * slot,void **frames,int num);
+int	H324MEngineReleaseFrames(void * engine,void * slot,void **frames,int num);
+int	H324MEngineGetState(void * engine,void * slot);
+int	H324MEngineEnd(void * engine,void * slot);
+char*	H324MEngineGetUserInput(void * engine,void * slot);
+int	H324MEngineSendUserInput(void * engine,void * slot,char *input);
+int	H324MEngineSendVideoFastUpdatePicture(void * engine,void * slot);
+int	H324MEngineSetTimeout(void * engine,void * slot,int timer,int ms);
+int	H324MEngineTick(void * engine,void * slot,int ms);
+int	H324MEngineSetTrace(void * engine,void * slot,int enabled);
+int	H324MEngineGetStats(void * engine,void * slot,H324MStats *stats);
 
 #ifdef __cplusplus    
 }
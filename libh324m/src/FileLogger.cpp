@@ -21,220 +21,205 @@
  */
 #include <stdarg.h>
 #include <stdio.h>
-#include <string.h>
-#include <sys/types.h>
-#include <sys/stat.h>
-#include <fcntl.h>
-#include <unistd.h>
 #include "FileLogger.h"
 
-FileLogger::FileLogger()
+FileLogger::FileLogger(TraceBuffer *t)
 {
+	//Session trace
+	trace = t;
+	//Ours if we don't have a session one
+	own = NULL;
+	//No bytes
 	num = 0;
-	l1 = line1+8;
-	l2 = line2;
-	memset(line3,' ',linesize);
+	bytesType = 0;
 }
 
 FileLogger::~FileLogger()
 {
+	//Write pending bytes
+	Flush();
+	//Delete our trace
+	delete own;
 }
 
-void FileLogger::SetMuxByte(BYTE b)
+void FileLogger::Flush()
+{
+	//If we have bytes
+	if (!num)
+		return;
+
+	//Append them in one record
+	GetTrace()->Append((DWORD)(size_t)this,bytesType,0,bytes,num);
+
+	//Empty
+	num = 0;
+}
+
+void FileLogger::Byte(BYTE type,BYTE b)
+{
+	//If we were storing other ones
+	if (num && bytesType!=type)
+		//Write them first
+		Flush();
+
+	//Store byte
+	bytesType = type;
+	bytes[num++] = b;
+
+	//If full
+	if (num==sizeof(bytes))
+		//Write them
+		Flush();
+}
+
+TraceBuffer* FileLogger::GetTrace()
+{
+	//If we don't have a session trace
+	if (!trace)
+		//Create our own
+		trace = own = new TraceBuffer();
+
+	//Return it
+	return trace;
+}
+
+void FileLogger::Dump(BYTE type,BYTE extra,BYTE *data,DWORD len)
 {
-	if (level>=5)
+	//Keep order with bytes
+	Flush();
+
+	//Append in records of max 64k
+	while (len)
 	{
-		//New line
-		if (num % 32 == 0)
-		{
-			if (num>0)
-			{
-				char name[256];
-				sprintf(name,"/tmp/h245_out_%p.log",this);
-				int fd = open(name,O_CREAT|O_WRONLY|O_APPEND, S_IRUSR | S_IWUSR );
-				if (fd!=-1)
-				{
-					write(fd,line1,linesize);
-					write(fd,"\r\n",2);
-					write(fd,line3,linesize);
-					write(fd,"\r\n",2);
-					close(fd);
-				}
-			} 
-			sprintf(line1,"%.8X ",num);
-			l1 = line1+8;
-		}
-
-		int numchar = sprintf(l1," %.2X",b);
-		l1[numchar] = ' ';
-		l1+=3;
-		num++;
+		//Get record size
+		WORD n = len>0xFFFF ? 0xFFFF : len;
+		//Append
+		GetTrace()->Append((DWORD)(size_t)this,type,extra,data,n);
+		//Next
+		data += n;
+		len -= n;
 	}
 }
 
+void FileLogger::SetMuxByte(BYTE b)
+{
+	if (IsTracing())
+		Byte(TraceBuffer::e_MuxBytes,b);
+}
+
 void FileLogger::SetMuxInfo(const char*info,...)
 {
-	if (level>=5)
+	if (IsTracing())
 	{
+		char line[256];
 		va_list ap;
 
 		//Set list
 		va_start(ap,info);
 
 		//Set line info
-		int numchar = vsprintf(l2,info,ap);
+		int numchar = vsnprintf(line,sizeof(line),info,ap);
 
 		//Reset list
 		va_end(ap);
 
-		//Remove \0
-		l2[numchar]=' ';
-
-		//Move l2
-		l2 += numchar;
-
-		//Calculate the remining
-		int rest = l2-line2-32*3;
-
-		//if we have past the end of line
-		if (rest>=0)
-		{
-			//Set to blank
-			memset(line3,' ',linesize);
-			//Copy to line3
-			memcpy(line3+8,line2,32*3);
-			//Move end of line2 to begining
-			memcpy(line2,line2+32*3,rest);
-			//Move to the begining
-			l2 = line2+rest;
-		}
+		//Check length
+		if (numchar>(int)sizeof(line)-1)
+			numchar = sizeof(line)-1;
+
+		//Append
+		Dump(TraceBuffer::e_MuxInfo,0,(BYTE*)line,numchar);
 	}
 }
 
 void FileLogger::SetDemuxByte(BYTE b)
 {
-	if (level>=5)
-	{
-		//New line
-		if (num % 32 == 0)
-		{
-			if (num>0)
-			{
-				char name[256];
-				sprintf(name,"/tmp/h245_%p.log",this);
-				int fd = open(name,O_CREAT|O_WRONLY|O_APPEND, S_IRUSR | S_IWUSR );
-				if (fd!=-1)
-				{
-					write(fd,line3,linesize-6);
-					if (line3[linesize-5]==' ') {
-						write(fd,line2+2,6);
-					} else if (line3[linesize-3]!=' ') {
-						write(fd,line3+linesize-6,3);
-						write(fd,line2+5,3);
-					} else {
-						write(fd,line3+linesize-6,6);
-					}
-					memset(line2,' ',8);
-					write(fd,"\r\n",2);
-					write(fd,line1,linesize);
-					write(fd,"\r\n",2);
-					memcpy(line3,line2,linesize);
-				}
-				close(fd);
-			} else
-				memset(line3,' ',linesize);
-			sprintf(line1,"%.8X ",num);
-			memset(line2,' ',linesize);
-			l1 = line1+8;
-			l2 = line2+8;
-
-		}
-		int numchar = sprintf(l1," %.2X",b);
-		l1[numchar] = ' ';
-		numchar = sprintf(l2,"   ");
-		l2[numchar] = ' ';
-		l1+=3;
-		l2+=3;
-		num++;
-	}
+	if (IsTracing())
+		Byte(TraceBuffer::e_DemuxBytes,b);
 }
 
 void FileLogger::SetDemuxInfo(int offset,const char*info,...)
 {
-	if (level>=5)
+	if (IsTracing())
 	{
+		char line[256];
 		va_list ap;
 
 		//Set list
 		va_start(ap,info);
 
 		//Set line info
-		int numchar = vsprintf(l2+offset,info,ap);
+		int numchar = vsnprintf(line,sizeof(line),info,ap);
 
 		//Reset list
 		va_end(ap);
 
-		//Remove \0
-		l2[numchar+offset]=' ';
+		//Check length
+		if (numchar>(int)sizeof(line)-1)
+			numchar = sizeof(line)-1;
+
+		//Append with the column offset
+		Dump(TraceBuffer::e_DemuxInfo,(BYTE)offset,(BYTE*)line,numchar);
 	}
 }
 
 void FileLogger::DumpMediaInput(BYTE *data,DWORD len)
 {
-	if (level>=5)
-	{
-		char name[256];
-		sprintf(name,"/tmp/media_in_%p.raw",this);
-		int fd = open(name,O_CREAT|O_WRONLY|O_APPEND, S_IRUSR | S_IWUSR );
-		if (fd!=-1)
-		{
-			write(fd,data,len);
-			close(fd);
-		}
-        }
+	if (IsTracing())
+		Dump(TraceBuffer::e_MediaInput,0,data,len);
 }
 
 void FileLogger::DumpMediaOutput(BYTE *data,DWORD len)
 {
-	if (level>=5)
-	{
-		char name[256];
-		sprintf(name,"/tmp/media_out_%p.raw",this);
-		int fd = open(name,O_CREAT|O_WRONLY|O_APPEND, S_IRUSR | S_IWUSR );
-		if (fd!=-1)
-		{
-			write(fd,data,len);
-			close(fd);
-		}
-	}
+	if (IsTracing())
+		Dump(TraceBuffer::e_MediaOutput,0,data,len);
 }
 
 void FileLogger::DumpInput(BYTE *data,DWORD len)
 {
-	if (level>=5)
-	{
-		char name[256];
-		sprintf(name,"/tmp/h223_in_%p.raw",this);
-		int fd = open(name,O_CREAT|O_WRONLY|O_APPEND, S_IRUSR | S_IWUSR );
-		if (fd!=-1)
-		{
-			write(fd,data,len);
-			close(fd);
-		}
-        }
+	if (IsTracing())
+		Dump(TraceBuffer::e_Input,0,data,len);
 }
 
 void FileLogger::DumpOutput(BYTE *data,DWORD len)
 {
-	if (level>=5)
+	if (IsTracing())
+		Dump(TraceBuffer::e_Output,0,data,len);
+}
+
+void FileLogger::DumpH245Input(const char *text,DWORD len)
+{
+	if (IsLoggingH245())
+		Dump(TraceBuffer::e_H245Input,0,(BYTE*)text,len);
+}
+
+void FileLogger::DumpH245Output(const char *text,DWORD len)
+{
+	if (IsLoggingH245())
+		Dump(TraceBuffer::e_H245Output,0,(BYTE*)text,len);
+}
+
+void FileLogger::SetH245Event(const char*info,...)
+{
+	if (IsLoggingH245())
 	{
-		char name[256];
-		sprintf(name,"/tmp/h223_out_%p.raw",this);
-		int fd = open(name,O_CREAT|O_WRONLY|O_APPEND, S_IRUSR | S_IWUSR );
-		if (fd!=-1)
-		{
-			write(fd,data,len);
-			close(fd);
-		}
-        }
+		char line[256];
+		va_list ap;
+
+		//Set list
+		va_start(ap,info);
+
+		//Set line info
+		int numchar = vsnprintf(line,sizeof(line),info,ap);
+
+		//Reset list
+		va_end(ap);
+
+		//Check length
+		if (numchar>(int)sizeof(line)-1)
+			numchar = sizeof(line)-1;
+
+		//Append
+		Dump(TraceBuffer::e_H245Event,0,(BYTE*)line,numchar);
+	}
 }
@@ -2,14 +2,14 @@
 #define _FILELOGGER_H_
 
 #include "log.h"
-#define linesize 104
+#include "TraceBuffer.h"
 
 class FileLogger : 
 	public Logger
 {
 public:
 	//Constructor
-	FileLogger();
+	FileLogger(TraceBuffer *trace = NULL);
 	virtual ~FileLogger();
 
 	//Logger interface
@@ -21,12 +21,24 @@ public:
 	virtual void DumpMediaOutput(BYTE *data,DWORD len);
 	virtual void DumpInput(BYTE *data,DWORD len);
 	virtual void DumpOutput(BYTE *data,DWORD len);
+	virtual void DumpH245Input(const char *text,DWORD len);
+	virtual void DumpH245Output(const char *text,DWORD len);
+	virtual void SetH245Event(const char *info,...);
+
+	//Trace everything at level 5 or if it's enabled for the session
+	int  IsTracing()	{ return GetLevel()>=5 || (trace && trace->IsEnabled()); }
+	//Log H.245 messages from debug level
+	int  IsLoggingH245()	{ return GetLevel()>=4 || (trace && trace->IsEnabled()); }
+private:
+	void Byte(BYTE type,BYTE b);
+	void Flush();
+	void Dump(BYTE type,BYTE extra,BYTE *data,DWORD len);
+	TraceBuffer* GetTrace();
 private:
-	char line1[linesize];
-	char line2[linesize];
-	char line3[linesize];
-	char *l1;
-	char *l2;
+	TraceBuffer *trace;
+	TraceBuffer *own;
+	BYTE bytes[32];
+	BYTE bytesType;
 	int num;
 };
 #endif
@@ -9,6 +9,8 @@ class H223ALReceiver
 public:
 	//H223ALReceiver interface
 	virtual void Send(BYTE b)=0;
+	virtual void Send(const BYTE *buffer,int len)=0;
+	virtual void SendReversed(const BYTE *buffer,int len)=0;
 	virtual void SendClosingFlag()=0;
 	virtual int IsSegmentable() = 0;
 	virtual ~H223ALReceiver() {}
@@ -29,6 +31,8 @@ class H223SDUListener
 public:
 	//H223SDUListener
 	virtual void OnSDU(BYTE* data,DWORD length) = 0;
+	//Zero copy version, sdu must be referenced to keep the data
+	virtual void OnSDU(H223MuxSDU *sdu,BYTE* data,DWORD length) { OnSDU(data,length); }
 	virtual ~H223SDUListener() {}
 };
 #endif
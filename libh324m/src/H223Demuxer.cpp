@@ -22,14 +22,21 @@
 #include <string.h>
 #include "H223Demuxer.h"
 #include "FileLogger.h"
+#include "bits.h"
 #define NONE  0
 #define HEAD  1
 #define PDU   2
 
-H223Demuxer::H223Demuxer()
+H223Demuxer::H223Demuxer(TraceBuffer *trace,Profiler *profiler)
 {
 	//Create logger
-	log = new FileLogger();
+	log = new FileLogger(trace);
+	//Store session profiler
+	this->profiler = profiler;
+	//No counters
+	memset(&stats,0,sizeof(stats));
+	//Bits in order by default
+	reverse = false;
 }
 
 H223Demuxer::~H223Demuxer()
@@ -68,6 +75,14 @@ int H223Demuxer::ReleaseChannel(int num)
 	return 1;
 }
 
+int H223Demuxer::SetReverseBits(int reverse)
+{
+	//Store the bit order of the input
+	this->reverse = reverse;
+
+	return 1;
+}
+
 int H223Demuxer::Open(H223MuxTable *table)
 {
 	//Check for null table
@@ -106,11 +121,13 @@ void H223Demuxer::StartPDU(H223Flag &flag)
 	//No channel
 	channel = -1;
 	//Log
-	log->SetDemuxInfo(-3,"flg");
+	TRACE(log,SetDemuxInfo(-3,"flg"));
 }
 
 void H223Demuxer::EndPDU(H223Flag &flag)
 {
+	//The closing flags are processed by the ALs
+	Profiler::Scope scope(profiler,Profiler::e_AL);
 
 	//Send closing flag to all non segmentable channels
 	for(ALReceiversMap::iterator it = al.begin(); it != al.end(); it++)
@@ -127,7 +144,7 @@ void H223Demuxer::EndPDU(H223Flag &flag)
 	if (flag.IsValid() && flag.complement)
 	{
 		//Log
-		log->SetDemuxInfo(-6,"dne");
+		TRACE(log,SetDemuxInfo(-6,"dne"));
 		
 		//if there is channel
 		if ((channel!=-1) && (al[channel]!=NULL))
@@ -135,7 +152,7 @@ void H223Demuxer::EndPDU(H223Flag &flag)
 			al[channel]->SendClosingFlag();
 	} else {
 		//Log
-		log->SetDemuxInfo(-6,"end");
+		TRACE(log,SetDemuxInfo(-6,"end"));
 		//if there is non-segmentable channel
 		if ((channel!=-1) && (al[channel]!=NULL) && !al[channel]->IsSegmentable())
 			//Send the closing pdu to the last channel
@@ -146,9 +163,36 @@ void H223Demuxer::EndPDU(H223Flag &flag)
 
 int H223Demuxer::Demultiplex(BYTE *buffer,int length)
 {
+	//Count
+	stats.bytes += length;
+
+	//If we are tracing each byte
+	if (TRACING(log))
+	{
+		//DeMux byte by byte
+		for (int i=0;i<length;i++)
+			Demultiplex(buffer[i]);
+		//Ok
+		return 1;
+	}
+
+	int i = 0;
+
 	//DeMux
-	for (int i=0;i<length;i++)
-		Demultiplex(buffer[i]);
+	while (i<length)
+	{
+		//If we are inside the pdu payload and there is nothing delayed in the flag
+		if (state==PDU && counter<header.mpl && flag.IsEmpty())
+			//Send the payload in blocks
+			i += SendPayload(buffer+i,length-i);
+		//If we are looking for a flag
+		else if (state==NONE && flag.IsComplete())
+			//Search it in the rest of the buffer
+			i += Hunt(buffer+i,length-i);
+		else
+			//Byte by byte
+			Demultiplex(buffer[i++]);
+	}
 
 	//Ok
 	return 1;
@@ -157,8 +201,12 @@ int H223Demuxer::Demultiplex(BYTE *buffer,int length)
 
 inline void H223Demuxer::Demultiplex(BYTE b)
 {
+	//Put the bits in order
+	if (reverse)
+		b = TIFFBitRevTable[b];
+
 	//Append to logger
-	log->SetDemuxByte(b);
+	TRACE(log,SetDemuxByte(b));
 
 	//Depending on the state
 	switch(state)
@@ -192,17 +240,43 @@ inline void H223Demuxer::Demultiplex(BYTE b)
 			if (!header.IsComplete())
 				return;
 	
-			//Is the header correct? And it's not stuffing ?
-			if (!header.IsValid() || !header.mpl)
+			//Is the header correct?
+			if (!header.IsValid())
+			{
+				//Count
+				stats.errors++;
+				stats.resyncs++;
+				//Reset state
+				state = NONE;
+				//Exit
+				return;
+			}
+
+			//If golay had to correct it
+			if (header.corrected)
+				//Count
+				stats.corrected++;
+
+			//If it's stuffing
+			if (!header.mpl)
 			{
+				//Count
+				stats.stuffing++;
 				//Reset state
 				state = NONE;
 				//Exit
 				return;
 			}
 
+			//One more
+			stats.pdus++;
+
 			//Log header
-			log->SetDemuxInfo(-6,"mc%.1dl%.2x",header.mc,header.mpl);
+			TRACE(log,SetDemuxInfo(-6,"mc%.1dl%.2x",header.mc,header.mpl));
+
+			//Get the channels for the whole payload
+			pattern = mux->GetPattern(header.mc);
+			spans = mux->GetSpans(header.mc);
 
 			//We have a good header go for the pdu
             		state = PDU;
@@ -219,8 +293,8 @@ inline void H223Demuxer::Demultiplex(BYTE b)
 			if (complete)
 				Send(a);
 
-			//While we are in the PDU
-			if (counter<header.mpl)
+			//While we are in the PDU or waiting for the closing flag
+			if (counter<header.mpl || !flag.IsComplete())
 				//And return
 				return;
 
@@ -241,9 +315,12 @@ inline void H223Demuxer::Demultiplex(BYTE b)
 
 				//Change state
 				state = HEAD;
-			} else 
+			} else {
+				//Lost sync
+				stats.resyncs++;
 				//No header found
 				state = NONE;
+			}
 			
 			break;
 	}
@@ -253,10 +330,10 @@ inline void H223Demuxer::Demultiplex(BYTE b)
 void H223Demuxer::Send(BYTE b)
 {
 	//Log
-	log->SetDemuxInfo(-9," xx");
+	TRACE(log,SetDemuxInfo(-9," xx"));
 	
-	//Get the next channel from the mux table
-	channel = mux->GetChannel(header.mc,counter++);
+	//Get the next channel from the pdu pattern
+	channel = pattern[counter++];
 
 	//Check channel
 	if ((channel<0) || (channel>15))
@@ -264,7 +341,10 @@ void H223Demuxer::Send(BYTE b)
 		return;
 
 	//Log
-	log->SetDemuxInfo(-9," n%.1d",channel);
+	TRACE(log,SetDemuxInfo(-9," n%.1d",channel));
+
+	//Count
+	stats.channelBytes[channel]++;
 
 	//Get channel
 	ALReceiversMap::iterator it = al.find(channel);
@@ -274,14 +354,120 @@ void H223Demuxer::Send(BYTE b)
 		return;
 
 	//Log
-	log->SetDemuxInfo(-9," c%.1d",channel);
+	TRACE(log,SetDemuxInfo(-9," c%.1d",channel));
 
 	//Get channel
 	H223ALReceiver *recv = it->second;
 
 	//If it's not null
 	if (recv)
+	{
+		//Charge it to the AL
+		Profiler::Scope scope(profiler,Profiler::e_AL);
 		//Send byte
 		recv->Send(b);
+	}
 }
 
+int H223Demuxer::SendPayload(BYTE *buffer,int length)
+{
+	//Get the pending payload of the pdu
+	int len = header.mpl-counter;
+
+	//Don't go past the buffer
+	if (len>length)
+		len = length;
+
+	int pos = 0;
+
+	//While we have data
+	while (pos<len)
+	{
+		//Get the channel of the next byte
+		channel = pattern[counter];
+
+		//Get the span of consecutive bytes for the same channel
+		int span = spans[counter];
+
+		//Don't go past the end
+		if (span>len-pos)
+			span = len-pos;
+
+		//Send them all together
+		Send(buffer+pos,span);
+
+		//Move
+		pos += span;
+		counter += span;
+	}
+
+	//Return consumed bytes
+	return len;
+}
+
+void H223Demuxer::Send(BYTE *buffer,int length)
+{
+	//Check channel
+	if ((channel<0) || (channel>15))
+		//Exit
+		return;
+
+	//Count
+	stats.channelBytes[channel] += length;
+
+	//Get channel
+	ALReceiversMap::iterator it = al.find(channel);
+
+	//If not found 
+	if (it==al.end())
+		return;
+
+	//Get channel
+	H223ALReceiver *recv = it->second;
+
+	//If it's not null
+	if (recv)
+	{
+		//Charge it to the AL
+		Profiler::Scope scope(profiler,Profiler::e_AL);
+		//If the bits are reversed
+		if (reverse)
+			//Send bytes putting the bits in order
+			recv->SendReversed(buffer,length);
+		else
+			//Send bytes
+			recv->Send(buffer,length);
+	}
+}
+
+int H223Demuxer::Hunt(BYTE *buffer,int length)
+{
+	//Append the first byte to check the flag with the previous data
+	Demultiplex(buffer[0]);
+
+	//If we found it or there is nothing more
+	if (state!=NONE || length<2)
+		//Exit
+		return 1;
+
+	//Search the next flag in the buffer
+	int pos = H223Flag::Find(buffer,length,reverse);
+
+	//Reset flag
+	flag.Clear();
+
+	//If not found
+	if (pos==-1)
+	{
+		//Keep just the last byte, the flag could be splitted
+		Demultiplex(buffer[length-1]);
+		//Consumed all
+		return length;
+	}
+
+	//Append the first byte of the flag, the next one will be appended byte by byte
+	Demultiplex(buffer[pos]);
+
+	//Return consumed
+	return pos+1;
+}
@@ -6,7 +6,8 @@
 #include "H223MuxTable.h"
 #include "H223Flag.h"
 #include "H223Header.h"
-#include "log.h"
+#include "FileLogger.h"
+#include "Profiler.h"
 
 #include <map>
 
@@ -17,20 +18,37 @@ private:
 
 public:
 	//Constructors
-	H223Demuxer();
+	H223Demuxer(TraceBuffer *trace = NULL,Profiler *profiler = NULL);
 	~H223Demuxer();
 	
 	int Open(H223MuxTable *table);
 	int SetChannel(int num,H223ALReceiver *receiver);
 	int ReleaseChannel(int num);
+	int SetReverseBits(int reverse);
 	void Demultiplex(BYTE b);
 	int  Demultiplex(BYTE *buffer,int length);
 	int Close();
 
+	//Counters
+	struct Stats
+	{
+		DWORD	bytes;
+		DWORD	pdus;
+		DWORD	stuffing;
+		DWORD	resyncs;
+		DWORD	corrected;
+		DWORD	errors;
+		DWORD	channelBytes[16];
+	};
+	const Stats& GetStats()	{ return stats; }
+
 private:
 	void StartPDU(H223Flag &flag);
 	void EndPDU(H223Flag &flag);
 	void Send(BYTE b);
+	void Send(BYTE *buffer,int length);
+	int  SendPayload(BYTE *buffer,int length);
+	int  Hunt(BYTE *buffer,int length);
 	int  DecodeHeader(H223Header &header);
 
 private:
@@ -39,12 +57,18 @@ private:
 	H223Flag		flag;
 	H223Header		header;
 	ALReceiversMap		al;
+	const short		*pattern;
+	const BYTE		*spans;
 	
 	int state;
 	int counter;
 	int channel;
+	int reverse;
+
+	Stats	stats;
 
-	Logger *log;
+	FileLogger *log;
+	Profiler *profiler;
 };
 
 #endif
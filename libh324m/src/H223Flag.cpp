@@ -21,6 +21,16 @@
  */
 #include "H223Flag.h"
 
+#if defined(__i386__) || defined(__x86_64__)
+#define FLAG_SIMD
+#include <immintrin.h>
+#endif
+
+#define FLAG0	0xE1
+#define FLAG1	0x4D
+#define FLAG0_REV	0x87
+#define FLAG1_REV	0xB2
+
 BYTE H223Flag::Append(BYTE b)
 {
 	BYTE out = 0;
@@ -53,6 +63,12 @@ int H223Flag::IsComplete()
 	return (length==2);
 }
 
+int H223Flag::IsEmpty()
+{
+	//Check length
+	return (length==0);
+}
+
 int H223Flag::IsValid()
 {
 	//Check length
@@ -60,7 +76,7 @@ int H223Flag::IsValid()
 		return 0;
 
 	//Check for flag
-	if (buffer[0]==0xE1 && buffer[1]==0x4D)
+	if (buffer[0]==FLAG0 && buffer[1]==FLAG1)
 	{
 		//Not complement
 		complement = 0;
@@ -69,7 +85,7 @@ int H223Flag::IsValid()
 	}
 
 	//Check for negative flag
-	if (buffer[0]==(BYTE)(~0xE1) && buffer[1]==(BYTE)(~0x4D))
+	if (buffer[0]==(BYTE)(~FLAG0) && buffer[1]==(BYTE)(~FLAG1))
 	{
 		//complement
 		complement = 1;
@@ -91,3 +107,127 @@ void H223Flag::Clear()
 	length = 0;
 }
 
+#ifdef FLAG_SIMD
+/**********************************
+* FindAVX2
+*	Check 32 candidates each time from *pos while a whole block fits
+*	Returns the position of the flag or -1, *pos is left after the last block
+***********************************/
+__attribute__((target("avx2"))) static int FindAVX2(const BYTE *buffer,int length,BYTE flag0,BYTE flag1,int *pos)
+{
+	int i = *pos;
+
+	//Flag bytes and complements
+	const __m256i f0 = _mm256_set1_epi8((char)flag0);
+	const __m256i f1 = _mm256_set1_epi8((char)flag1);
+	const __m256i c0 = _mm256_set1_epi8((char)~flag0);
+	const __m256i c1 = _mm256_set1_epi8((char)~flag1);
+
+	for (;i+32<length;i+=32)
+	{
+		//Load first and second bytes
+		__m256i a = _mm256_loadu_si256((const __m256i*)(buffer+i));
+		__m256i b = _mm256_loadu_si256((const __m256i*)(buffer+i+1));
+		//Match flag or complement
+		__m256i f = _mm256_and_si256(_mm256_cmpeq_epi8(a,f0),_mm256_cmpeq_epi8(b,f1));
+		__m256i c = _mm256_and_si256(_mm256_cmpeq_epi8(a,c0),_mm256_cmpeq_epi8(b,c1));
+		//Get mask
+		unsigned int mask = _mm256_movemask_epi8(_mm256_or_si256(f,c));
+		//If found
+		if (mask)
+			return i+__builtin_ctz(mask);
+	}
+
+	//Not found in the blocks
+	*pos = i;
+	return -1;
+}
+
+/**********************************
+* FindSSE2
+*	Same with 16 candidates each time
+***********************************/
+__attribute__((target("sse2"))) static int FindSSE2(const BYTE *buffer,int length,BYTE flag0,BYTE flag1,int *pos)
+{
+	int i = *pos;
+
+	//Flag bytes and complements
+	const __m128i f0 = _mm_set1_epi8((char)flag0);
+	const __m128i f1 = _mm_set1_epi8((char)flag1);
+	const __m128i c0 = _mm_set1_epi8((char)~flag0);
+	const __m128i c1 = _mm_set1_epi8((char)~flag1);
+
+	for (;i+16<length;i+=16)
+	{
+		//Load first and second bytes
+		__m128i a = _mm_loadu_si128((const __m128i*)(buffer+i));
+		__m128i b = _mm_loadu_si128((const __m128i*)(buffer+i+1));
+		//Match flag or complement
+		__m128i f = _mm_and_si128(_mm_cmpeq_epi8(a,f0),_mm_cmpeq_epi8(b,f1));
+		__m128i c = _mm_and_si128(_mm_cmpeq_epi8(a,c0),_mm_cmpeq_epi8(b,c1));
+		//Get mask
+		unsigned int mask = _mm_movemask_epi8(_mm_or_si128(f,c));
+		//If found
+		if (mask)
+			return i+__builtin_ctz(mask);
+	}
+
+	//Not found in the blocks
+	*pos = i;
+	return -1;
+}
+
+static int FindNone(const BYTE *buffer,int length,BYTE flag0,BYTE flag1,int *pos)
+{
+	return -1;
+}
+
+//Selected once at load time from what the cpu supports, scalar until then
+static int (*FindSIMD)(const BYTE*,int,BYTE,BYTE,int*) = FindNone;
+
+__attribute__((constructor)) static void SelectFind()
+{
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2"))
+		FindSIMD = FindAVX2;
+	else if (__builtin_cpu_supports("sse2"))
+		FindSIMD = FindSSE2;
+}
+#endif
+
+/**********************************
+* Find
+*	Search the first flag or complement flag in the buffer
+*	If reversed the bits of each byte of the buffer are in the
+*	opposite order, so the flag is searched with its bits reversed
+*	Returns the position of the first byte of the flag or -1
+***********************************/
+int H223Flag::Find(const BYTE *buffer,int length,int reversed)
+{
+	int i = 0;
+
+	//Flag bytes as they are in the buffer
+	const BYTE flag0 = reversed ? FLAG0_REV : FLAG0;
+	const BYTE flag1 = reversed ? FLAG1_REV : FLAG1;
+
+#ifdef FLAG_SIMD
+	//Check the whole blocks with the widest compare the cpu has
+	int found = FindSIMD(buffer,length,flag0,flag1,&i);
+	//If found
+	if (found!=-1)
+		return found;
+#endif
+	//Check the rest byte by byte
+	for (;i+1<length;i++)
+	{
+		//Flag
+		if (buffer[i]==flag0 && buffer[i+1]==flag1)
+			return i;
+		//Complement
+		if (buffer[i]==(BYTE)~flag0 && buffer[i+1]==(BYTE)~flag1)
+			return i;
+	}
+
+	//Not found
+	return -1;
+}
@@ -7,8 +7,12 @@ class H223Flag
 public:
 	BYTE Append(BYTE b);
 	int  IsComplete();
+	int  IsEmpty();
 	int  IsValid();
 	void Clear();
+
+	static int Find(const BYTE *buffer,int length,int reversed = false);
+public:
 	int		complement;
 private:
 	int		level;
@@ -45,14 +45,20 @@ int H223Header::IsValid()
 	//Calculate the golay code
 	DWORD golay = buffer[2] << 16 | buffer[1] << 8 | buffer[0];
 
-	//Decode it
-	int code = golay_decode(golay);
+	//Get the errors
+	int errors = golay_errors(golay);
 
 	//Chek it
-	if (code==-1)
+	if (errors==-1)
 		//Bad header
 		return 0;
 
+	//Correct the data bits
+	int code = (golay ^ errors) & 0xFFF;
+
+	//If there was any error
+	corrected = (errors!=0);
+
 	//Get the values
 	mc  = code & 0x0F;
 	mpl = (code >> 4 ) & 0xFF;
@@ -101,4 +107,7 @@ void H223Header::Clear()
 
 	//And the length
 	length = 0;
+
+	//No errors
+	corrected = 0;
 }
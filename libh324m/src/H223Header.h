@@ -14,6 +14,8 @@ public:
 	BYTE	mc;
 	BYTE	pm;
 	BYTE	mpl;
+	//Errors corrected in the last valid header
+	int	corrected;
 private:
 	int	level;
 	BYTE	buffer[3];
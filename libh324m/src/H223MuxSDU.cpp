@@ -20,6 +20,8 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
  */
 #include "H223MuxSDU.h"
+#include "H223MuxSDUPool.h"
+#include "bits.h"
 
 H223MuxSDU::H223MuxSDU()
 {
@@ -30,6 +32,31 @@ H223MuxSDU::H223MuxSDU()
 	ini = 0;
 	end = 0;
 
+	//Not pooled
+	pool = NULL;
+	next = NULL;
+	prev = NULL;
+	refs = 1;
+
+	//Allocate memory
+	buffer = (BYTE*)malloc(size);
+}
+
+H223MuxSDU::H223MuxSDU(H223MuxSDUPool *p,int s)
+{
+	//Set size
+	size = s;
+
+	//Set pointers
+	ini = 0;
+	end = 0;
+
+	//Pooled
+	pool = p;
+	next = NULL;
+	prev = NULL;
+	refs = 1;
+
 	//Allocate memory
 	buffer = (BYTE*)malloc(size);
 }
@@ -40,7 +67,7 @@ H223MuxSDU::~H223MuxSDU()
 	free(buffer);
 }
 
-H223MuxSDU::H223MuxSDU(BYTE *b,int len)
+H223MuxSDU::H223MuxSDU(const BYTE *b,int len)
 {
 	//Set the size
 	size = len+256;
@@ -54,6 +81,34 @@ H223MuxSDU::H223MuxSDU(BYTE *b,int len)
 	//Set end
 	end = len;
 	ini = 0;
+
+	//Not pooled
+	pool = NULL;
+	next = NULL;
+	prev = NULL;
+	refs = 1;
+}
+
+void H223MuxSDU::AddRef()
+{
+	//One more
+	refs++;
+}
+
+void H223MuxSDU::Release()
+{
+	//If it's still in use
+	if (--refs>0)
+		//Exit
+		return;
+
+	//If it's pooled
+	if (pool)
+		//Give it back
+		pool->Recycle(this);
+	else
+		//Delete
+		delete this;
 }
 
 int H223MuxSDU::Push(BYTE b)
@@ -84,7 +139,7 @@ int H223MuxSDU::Push(BYTE b)
 	return 1;
 }
 
-int H223MuxSDU::Push(BYTE *b,int len)
+int H223MuxSDU::Push(const BYTE *b,int len)
 {
 	//Check if there is enougth room
 	if (end+len>size)
@@ -115,6 +170,37 @@ int H223MuxSDU::Push(BYTE *b,int len)
 	return len;
 }
 
+int H223MuxSDU::PushReversed(const BYTE *b,int len)
+{
+	//Check if there is enougth room
+	if (end+len>size)
+	{
+		//Increment size
+		size += len+256;
+
+		//incremente size
+		BYTE *aux = (BYTE*)malloc(size);
+
+		//Copy the buffer
+		memcpy(aux,buffer,end);
+
+		//Free old buffer
+		free(buffer);
+
+		//Set new buffer
+		buffer = aux;
+	}
+
+	//Insert reversing the bits of each byte
+	TIFFReverseBitsCopy(buffer+end,b,len);
+
+	//Increase end
+	end+=len;
+
+	//Return added
+	return len;
+}
+
 BYTE H223MuxSDU::Pop()
 {
 	if(ini>=end)
@@ -123,6 +209,30 @@ BYTE H223MuxSDU::Pop()
 	return buffer[ini++];
 }
 
+int H223MuxSDU::Pop(BYTE *b,int len)
+{
+	if(ini+len>end)
+		*((BYTE*)0)=0;
+	//Copy
+	memcpy(b,buffer+ini,len);
+	//Move
+	ini+=len;
+	//Exit
+	return len;
+}
+
+int H223MuxSDU::PopReversed(BYTE *b,int len)
+{
+	if(ini+len>end)
+		*((BYTE*)0)=0;
+	//Copy reversing the bits of each byte
+	TIFFReverseBitsCopy(b,buffer+ini,len);
+	//Move
+	ini+=len;
+	//Exit
+	return len;
+}
+
 int	 H223MuxSDU::Length()
 {
 	return end-ini;
@@ -6,16 +6,27 @@
 #include <list>
 #include <map>
 
+class H223MuxSDUPool;
+
 class H223MuxSDU
 {
 public:
 	H223MuxSDU();
-	H223MuxSDU(BYTE *b,int len);
+	H223MuxSDU(const BYTE *b,int len);
+	H223MuxSDU(H223MuxSDUPool *pool,int size);
 	~H223MuxSDU();
+
+	//Reference counting, the last release returns it to the pool
+	void AddRef();
+	void Release();
 	
 	int  Push(BYTE b);
-	int  Push(BYTE *b,int len);
+	int  Push(const BYTE *b,int len);
 	BYTE Pop();
+	int  Pop(BYTE *b,int len);
+	//Same as above but reversing the bit order of the bytes
+	int  PushReversed(const BYTE *b,int len);
+	int  PopReversed(BYTE *b,int len);
 	BYTE *GetPointer() {return buffer;}
 	int  Length();
 
@@ -23,10 +34,17 @@ public:
 	void Clean();
 
 private:
+	friend class H223MuxSDUPool;
+
 	BYTE *buffer;
 	int ini;
 	int end;
 	int size;
+	int refs;
+	H223MuxSDUPool *pool;
+	//Free list of the pool, or the in use one while out of it
+	H223MuxSDU *next;
+	H223MuxSDU *prev;
 };
 
 typedef std::map<int,H223MuxSDU*> H223MuxSDUMap;
@@ -0,0 +1,145 @@
+/* H324M library
+ *
+ * Copyright (C) 2006 Sergio Garcia Murillo
+ *
+ * sergio.garcia@fontventa.com
+ * http://sip.fontventa.com
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+#include "H223MuxSDUPool.h"
+
+//Size of each class
+static const int classSize[] = {64,192,320};
+
+H223MuxSDUPool::H223MuxSDUPool()
+{
+	//Empty lists
+	for (int i=0;i<NumClasses;i++)
+	{
+		cached[i] = NULL;
+		num[i] = 0;
+	}
+	//None in use
+	used = NULL;
+}
+
+H223MuxSDUPool::~H223MuxSDUPool()
+{
+	//For each class
+	for (int i=0;i<NumClasses;i++)
+	{
+		//Delete cached sdus
+		while (cached[i])
+		{
+			//Get first
+			H223MuxSDU *sdu = cached[i];
+			//Move to next
+			cached[i] = sdu->next;
+			//Delete
+			delete sdu;
+		}
+	}
+
+	//Detach the ones still in use
+	while (used)
+	{
+		//Get first
+		H223MuxSDU *sdu = used;
+		//Move to next
+		used = sdu->next;
+		//Not pooled any more, deleted on last release
+		sdu->pool = NULL;
+		sdu->next = NULL;
+		sdu->prev = NULL;
+	}
+}
+
+H223MuxSDU* H223MuxSDUPool::Create(int size)
+{
+	int i = 0;
+
+	//Find the class
+	while (i<NumClasses && classSize[i]<size)
+		i++;
+
+	//If it's too big for any class
+	if (i==NumClasses)
+		//Create one that will not be cached
+		return Use(new H223MuxSDU(this,size));
+
+	//If we don't have any free
+	if (!cached[i])
+		//Create a new one
+		return Use(new H223MuxSDU(this,classSize[i]));
+
+	//Get first
+	H223MuxSDU *sdu = cached[i];
+
+	//Remove from list
+	cached[i] = sdu->next;
+	num[i]--;
+
+	//Init it
+	sdu->refs = 1;
+
+	//Return it
+	return Use(sdu);
+}
+
+H223MuxSDU* H223MuxSDUPool::Use(H223MuxSDU *sdu)
+{
+	//Append to the in use list
+	sdu->prev = NULL;
+	sdu->next = used;
+	if (used)
+		used->prev = sdu;
+	used = sdu;
+
+	//Return it
+	return sdu;
+}
+
+void H223MuxSDUPool::Recycle(H223MuxSDU *sdu)
+{
+	//Remove from the in use list
+	if (sdu->prev)
+		sdu->prev->next = sdu->next;
+	else
+		used = sdu->next;
+	if (sdu->next)
+		sdu->next->prev = sdu->prev;
+	sdu->prev = NULL;
+
+	//For each class
+	for (int i=0;i<NumClasses;i++)
+	{
+		//If it's this class and there is room
+		if (sdu->size==classSize[i] && num[i]<MaxFree)
+		{
+			//Clean it
+			sdu->Clean();
+			//Append to the list
+			sdu->next = cached[i];
+			cached[i] = sdu;
+			num[i]++;
+			//Exit
+			return;
+		}
+	}
+
+	//It was resized or there are too many
+	delete sdu;
+}
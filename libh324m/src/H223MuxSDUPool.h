@@ -0,0 +1,34 @@
+#ifndef _H223MUXSDUPOOL_H_
+#define _H223MUXSDUPOOL_H_
+
+#include "H223MuxSDU.h"
+
+/**********************************
+* H223MuxSDUPool
+*	Per session cache of sdus sorted by size class so audio (~33 bytes),
+*	video (~162 bytes) and control (up to 261 bytes) sdus are reused 
+*	instead of allocated for each frame. It's not thread safe, the pool 
+*	must only be used from the thread driving the session.
+*	The sdus still in use when it's deleted, like the ones of the frames
+*	not yet destroyed, are detached and deleted on their last release.
+***********************************/
+class H223MuxSDUPool
+{
+public:
+	H223MuxSDUPool();
+	~H223MuxSDUPool();
+
+	H223MuxSDU* Create(int size);
+	void Recycle(H223MuxSDU *sdu);
+
+private:
+	H223MuxSDU* Use(H223MuxSDU *sdu);
+
+	enum { NumClasses = 3, MaxFree = 64 };
+
+	H223MuxSDU*	cached[NumClasses];
+	int		num[NumClasses];
+	H223MuxSDU*	used;
+};
+
+#endif
@@ -91,15 +91,25 @@ H223MuxTable::H223MuxTable()
 {
 	//All tables to null
 	for (int i=0;i<16;i++)
+	{
+		//Empty
 		entries[i] = NULL;
+		served[i] = NULL;
+		//Expand it
+		Expand(i);
+	}
 }
 
 H223MuxTable::~H223MuxTable()
 {
 	//Delete al tables
 	for (int i=0;i<16;i++)
+	{
 		if (entries[i])
 			delete entries[i];
+		if (served[i])
+			delete[] served[i];
+	}
 }
 int H223MuxTable::IsSet(int mc)
 {
@@ -119,6 +129,9 @@ int H223MuxTable::SetEntry(int mc,const char* f,const char *r)
 	//Create a new entrie
 	entries[mc] = new H223MuxTableEntry(f,r);
 
+	//Expand the pattern
+	Expand(mc);
+
 	//good
 	return 1;
 
@@ -138,11 +151,139 @@ int H223MuxTable::SetEntry(int mc,H223MuxTableEntry *entry)
 	//Create a new entrie
 	entries[mc] = entry;
 
+	//Expand the pattern
+	Expand(mc);
+
 	//good
 	return 1;
 }
 
 int H223MuxTable::GetChannel(int mc,int count)
+{
+	//If the mc is not valid
+	if (mc>=16)
+		return -1;
+
+	//If it's inside the expanded pattern
+	if (count<256)
+		return pattern[mc][count];
+
+	//Calculate it
+	return CalcChannel(mc,count);
+}
+
+const short* H223MuxTable::GetPattern(int mc)
+{
+	//Return the channel of each byte of a pdu with that mc
+	return pattern[mc];
+}
+
+const BYTE* H223MuxTable::GetSpans(int mc)
+{
+	//Return the number of consecutive bytes for the same channel of each byte
+	return spans[mc];
+}
+
+int H223MuxTable::GetLength(int mc)
+{
+	//Return the number of bytes before the pattern ends
+	return length[mc];
+}
+
+int H223MuxTable::GetNumServed(int mc)
+{
+	//Return the number of different channels in the pattern
+	return numServed[mc];
+}
+
+const H223MuxTableChannel* H223MuxTable::GetServed(int mc)
+{
+	//Return the channels in the pattern
+	return served[mc];
+}
+
+void H223MuxTable::Expand(int mc)
+{
+	//For each byte of the pdu
+	for (int i=0;i<256;i++)
+		//Get channel
+		pattern[mc][i] = CalcChannel(mc,i);
+
+	//Delete previous served channels
+	if (served[mc])
+		delete[] served[mc];
+
+	//Reset
+	served[mc] = NULL;
+	numServed[mc] = 0;
+	length[mc] = 0;
+
+	//Find the end of the pattern
+	while (length[mc]<256 && pattern[mc][length[mc]]!=-1)
+		length[mc]++;
+
+	//If it's not empty
+	if (length[mc])
+	{
+		int index[256];
+		int num = 0;
+
+		//Nothing found yet
+		for (int c=0;c<256;c++)
+			index[c] = -1;
+
+		//Mark the channels used
+		for (int i=0;i<length[mc];i++)
+			index[pattern[mc][i]] = 0;
+
+		//Number them in channel order
+		for (int c=0;c<256;c++)
+			if (index[c]!=-1)
+				index[c] = num++;
+
+		//Allocate them
+		served[mc] = new H223MuxTableChannel[num];
+
+		//Init them
+		for (int c=0;c<256;c++)
+		{
+			//If it's used
+			if (index[c]!=-1)
+			{
+				//Set channel
+				served[mc][index[c]].channel = c;
+				served[mc][index[c]].capacity = 0;
+			}
+		}
+
+		//Set the number of channels
+		numServed[mc] = num;
+
+		//For each byte of the pattern
+		for (int i=0;i<length[mc];i++)
+		{
+			//Get channel
+			H223MuxTableChannel &chan = served[mc][index[pattern[mc][i]]];
+			//Append position
+			chan.pos[chan.capacity++] = i;
+		}
+	}
+
+	//The last one
+	spans[mc][255] = 1;
+
+	//Calculate the spans backwards
+	for (int i=254;i>=0;i--)
+		//If it's the same channel than next one
+		if (pattern[mc][i]==pattern[mc][i+1] && spans[mc][i+1]<255)
+			//Increase span
+			spans[mc][i] = spans[mc][i+1]+1;
+		else
+			//New span
+			spans[mc][i] = 1;
+}
+
+int H223MuxTable::CalcChannel(int mc,int count)
 {
 	//If the mc is valid
 	if (mc>=16 || !entries[mc])
@@ -180,7 +321,13 @@ H223MuxTable::H223MuxTable(const H245_MultiplexEntrySend & pdu)
 {
 	//All tables to null
 	for (int i=0;i<16;i++)
+	{
+		//Empty
 		entries[i] = NULL;
+		served[i] = NULL;
+		//Expand it
+		Expand(i);
+	}
 
 	//For each descriptor
 	for (int i=0;i<pdu.m_multiplexEntryDescriptors.GetSize();i++)
@@ -20,6 +20,13 @@ struct H223MuxTableEntry
 };
 
 
+struct H223MuxTableChannel
+{
+	int	channel;	//Logical channel number
+	int	capacity;	//Number of bytes of the channel in the expanded pattern
+	BYTE	pos[256];	//Position of each byte of the channel in the pattern
+};
+
 class H223MuxTable
 {
 public:
@@ -30,10 +37,23 @@ public:
 	int SetEntry(int mc,const char* f,const char *r);
 	int SetEntry(int mc,H223MuxTableEntry *entry);
 	int GetChannel(int mc,int count);
+	const short* GetPattern(int mc);
+	const BYTE* GetSpans(int mc);
+	int GetLength(int mc);
+	int GetNumServed(int mc);
+	const H223MuxTableChannel* GetServed(int mc);
 	void BuildPDU(H245_MultiplexEntrySend & pdu);
 	int AppendEntries(H223MuxTable &table,H223MuxTableEntryList &list);
+protected:
+	void Expand(int mc);
+	int  CalcChannel(int mc,int count);
 protected:
 	H223MuxTableEntry*	entries[16];
+	short			pattern[16][256];
+	BYTE			spans[16][256];
+	int			length[16];
+	int			numServed[16];
+	H223MuxTableChannel*	served[16];
 };
 
 #endif
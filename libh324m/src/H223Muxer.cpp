@@ -19,22 +19,36 @@
  * along with this program; if not, write to the Free Software
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
  */
+#include <algorithm>
 #include "H223Muxer.h"
 #include "FileLogger.h"
+#include "bits.h"
 
 extern "C"
 {
 #include "golay.h"
 }
 
-H223Muxer::H223Muxer()
+H223Muxer::H223Muxer(TraceBuffer *trace)
 {
 	//Create logger
-	log = new FileLogger();
+	log = new FileLogger(trace);
+	//Default policy
+	policy = e_FillRatio;
+	//No sdus
+	memset(sduLen,0,sizeof(sduLen));
+	//Bits in order by default
+	reverse = false;
+	//No counters
+	memset(&stats,0,sizeof(stats));
 }
 
 H223Muxer::~H223Muxer()
 {
+	//Release the sdus still being sent
+	for (H223MuxSDUMap::iterator it=sdus.begin();it!=sdus.end();++it)
+		//Release our reference
+		it->second->Release();
 	//Delete logger
 	delete log;
 }
@@ -94,14 +108,55 @@ int H223Muxer::ReleaseChannel(int num)
 	// Remove channel from map
 	senders.erase(it);
 
+	// Find the sdu being sent on it
+	H223MuxSDUMap::iterator itSDU = sdus.find(num);
+
+	// If we had one
+	if (itSDU!=sdus.end())
+	{
+		// Release our reference
+		itSDU->second->Release();
+		// Remove from map
+		sdus.erase(itSDU);
+	}
+
 	// Exit
 	return 1;
 }
 
+int H223Muxer::SetPolicy(Policy p)
+{
+	//Check it
+	switch(p)
+	{
+		case e_FillRatio:
+		case e_AudioFirst:
+		case e_Throughput:
+			//Save it
+			policy = p;
+			return 1;
+	}
+	//Unknown
+	return 0;
+}
+
+int H223Muxer::SetReverseBits(int reverse)
+{
+	//Store the bit order of the output
+	this->reverse = reverse;
+
+	return 1;
+}
+
 /**********************************
 * GetBestMC
 *	Search the best mc entry and calculate de mpl of the pdu
-*   Currently best result is the one that
+*	For each entry we calculate where the pdu would stop from the
+*	positions of the channels in the expanded pattern and score it
+*	depending on the policy:
+*	 e_FillRatio	sum of the ratio of each sdu sent
+*	 e_AudioFirst	same but non segmentable (audio) sdus go first
+*	 e_Throughput	number of bytes sent
 ***********************************/
 int H223Muxer::GetBestMC(int max)
 {
@@ -112,7 +167,7 @@ int H223Muxer::GetBestMC(int max)
 	mpl = 0;
 	pm = 0;
 
-	//best ratio
+	//best score
 	float best = 0;
 
 	//Check for new request
@@ -129,94 +184,310 @@ int H223Muxer::GetBestMC(int max)
 
 			//If it's not null
 			if (sdu!=NULL)
+			{
+				//Keep a reference while we send it
+				sdu->AddRef();
 				//Append
 				sdus[channel] = sdu;
+			}
 		}
 	}
 	
-	//Map and iterators
-	WORD len[256];
-	WORD sduLen[256];
-
-	//Reset length
-	memset(sduLen,0,256*sizeof(WORD));
-
 	//For each sdu
 	for (itSDUS=sdus.begin();itSDUS!=sdus.end();itSDUS++)
-		sduLen[itSDUS->first] = itSDUS->second->Length();
+	{
+		//Get channel
+		int c = itSDUS->first;
+		//Set length
+		sduLen[c] = itSDUS->second->Length();
+		//And if the sender is segmentable
+		segmentable[c] = senders[c]->IsSegmentable();
+	}
 	
 	//For each table
 	for (int i=0;i<16;i++)
 	{
-		int j = 0;
+		//Get the channels of the entry
+		const H223MuxTableChannel *served = table->GetServed(i);
+		int num = table->GetNumServed(i);
+
+		//By default send until the end of the pattern
+		int j = table->GetLength(i);
 		int end = 0;
 
-		//Reset lengths
-		memset(len,0,256*sizeof(WORD));
+		//Up to the max size
+		if (j>max)
+			j = max;
 
-		//While not done
-		while(j<max)
+		//For each channel find where it would stop the pdu
+		for (int k=0;k<num;k++)
 		{
-			//Get next channel for table
-			int c = table->GetChannel(i,j);
+			//Get channel
+			int c = served[k].channel;
+			int stop;
+			int ends;
 
-			//If we don't have a mux for that channel
-			if (c==-1 || sduLen[c]==0)
-				break;
-
-			 //If channel is non-segmentble and it was already ended
-			if (!senders[c]->IsSegmentable() && (len[c] == sduLen[c]))
-				//Exit
-				break;
-			
-			//Increase counter
-			len[c]++;
-			j++;
-			
-			//If channel is segmentble and it has ended
-			if (senders[c]->IsSegmentable() && (len[c] == sduLen[c]))
+			//If we don't have a sdu for that channel
+			if (!sduLen[c])
 			{
-				//Finish sdu
-				end = 1;
-				//Exit
-				break;
+				//Stop before its first byte
+				stop = served[k].pos[0];
+				ends = 0;
+			} else if (segmentable[c]) {
+				//If the sdu can't end inside the pattern
+				if (sduLen[c]>served[k].capacity)
+					continue;
+				//Stop after the last byte of the sdu
+				stop = served[k].pos[sduLen[c]-1]+1;
+				ends = 1;
+			} else {
+				//If the sdu can't end inside the pattern
+				if (sduLen[c]>=served[k].capacity)
+					continue;
+				//Stop before sending more than the sdu
+				stop = served[k].pos[sduLen[c]];
+				ends = 0;
 			}
 
+			//If it's before or it's ending the sdu at the same point
+			if (stop<j || (stop==j && ends))
+			{
+				//Stop here
+				j = stop;
+				end = ends;
+			}
 		}
 
-		//Calculate ratio
+		//Calculate ratios
 		float ratio = 0;
+		float audio = 0;
+
+		//For each channel
+		for (int k=0;k<num;k++)
+		{
+			//Get channel
+			int c = served[k].channel;
+
+			//If we don't have sdu
+			if (!sduLen[c])
+				continue;
+
+			//Get the number of bytes sent before the end
+			int len = std::lower_bound(served[k].pos,served[k].pos+served[k].capacity,j) - served[k].pos;
+
+			//If nothing
+			if (!len)
+				continue;
+
+			//Increase ratio
+			ratio += (float)len/sduLen[c];
+
+			//If it's non segmentable
+			if (!segmentable[c])
+				//Increase the audio ratio
+				audio += (float)len/sduLen[c];
+		}
+
+		//Calculate score
+		float score;
 
-		//For each sdu
-		for (int k=0;k<256;k++)
-			if (len[k]>0)
-				ratio +=  (float)len[k]/sduLen[k];
+		//Depending on the policy
+		switch(policy)
+		{
+			case e_AudioFirst:
+				//Audio goes first, the rest only breaks ties
+				score = audio*16 + ratio;
+				break;
+			case e_Throughput:
+				//Bytes sent, the ratio only breaks ties
+				score = j + ratio/256;
+				break;
+			default:
+				//The sdus filled
+				score = ratio;
+				break;
+		}
 
-		//If the ratio is better
-		if (ratio>best)
+		//If the score is better
+		if (score>best)
 		{
 			//Save values
 			mc = i;
 			mpl = j;
 			pm = end;
-			best = ratio;
+			best = score;
 		}
 	}
 
+	//Reset sdu lengths
+	for (itSDUS=sdus.begin();itSDUS!=sdus.end();itSDUS++)
+		sduLen[itSDUS->first] = 0;
+
 	//If we found something
 	return mc!=-1;
 }
 
 int H223Muxer::Multiplex(BYTE *buffer,int length)
 {
+	//Count
+	stats.bytes += length;
+
+	//If we are tracing each byte
+	if (TRACING(log))
+	{
+		//Mux byte by byte
+		for (int i=0;i<length;i++)
+			buffer[i] = Multiplex();
+		//Ok
+		return 1;
+	}
+
+	int pos = 0;
+
 	//Mux
-	for (int i=0;i<length;i++)
-		buffer[i] = Multiplex();
+	while (pos<length)
+	{
+		//Depending on the state
+		switch(state)
+		{
+			case NONE:
+				//Create flag and header of next pdu
+				BuildHeader();
+				//Send pdu
+				state = PDU;
+				break;
+			case PDU:
+				//If we still haven't sent the flag & header
+				if (i<size)
+				{
+					//Get how much we can copy
+					int len = size-i;
+					//Don't go past the buffer
+					if (len>length-pos)
+						len = length-pos;
+					//Copy header
+					if (reverse)
+						TIFFReverseBitsCopy(buffer+pos,(BYTE*)this->buffer+i,len);
+					else
+						memcpy(buffer+pos,this->buffer+i,len);
+					//Move
+					i += len;
+					pos += len;
+				//If we haven't finished
+				} else if (j<mpl) {
+					//Get how much we can copy
+					int len = mpl-j;
+					//Don't go past the buffer
+					if (len>length-pos)
+						len = length-pos;
+					//Next channel
+					channel = table->GetPattern(mc)[j];
+					//Get the span of bytes for the same channel
+					int span = table->GetSpans(mc)[j];
+					//Don't go past the end
+					if (span>len)
+						span = len;
+					//Count, only the channels of the stats
+					if (channel>=0 && channel<16)
+						stats.channelBytes[channel] += span;
+					//Copy them from the sdu
+					if (reverse)
+						sdus[channel]->PopReversed(buffer+pos,span);
+					else
+						sdus[channel]->Pop(buffer+pos,span);
+					//Move
+					j += span;
+					pos += span;
+				} else {
+					//End pdu
+					EndPDU();
+					//No state
+					state = NONE;
+				}
+				break;
+		}
+	}
 
 	//Ok
 	return 1;
 }
 
+void H223Muxer::BuildHeader()
+{
+	//Reset channel
+	channel = -1;
+	//If we have to finish last packet
+	if (!pm)
+	{
+		//Create the flag
+		buffer[0] = 0xE1;
+		buffer[1] = 0x4D;
+
+		//Log
+		TRACE(log,SetMuxInfo("endflg"));
+	} else {
+		//Create the flag
+		buffer[0] = (BYTE)~0xE1;
+		buffer[1] = (BYTE)~0x4D;
+		//Log
+		TRACE(log,SetMuxInfo("dneflg"));
+	}
+
+	//Get the best mc & mpl from the table
+	if (GetBestMC(160))
+	{
+		//Calculate p bits
+		WORD data = (mc & 0x0F) | mpl << 4;
+		//Get the codeword
+		long code = golay_encode(data);
+
+		//Create the header
+		buffer[2] = ((BYTE *)&code)[0];//(mc & 0x0F) | (mpl &0x0F) << 4;
+		buffer[3] = ((BYTE *)&code)[1];//(mpl &0xF0) >> 4;
+		buffer[4] = ((BYTE *)&code)[2];//0x00;
+		//One more
+		stats.pdus++;
+		//Log
+		TRACE(log,SetMuxInfo("   mc%.1d %.2x",mc,mpl));
+	} else {
+		//Create the header
+		buffer[2] = 0x00;
+		buffer[3] = 0x00;
+		buffer[4] = 0x00;
+		//Stuffing
+		stats.stuffing++;
+		//Log
+		TRACE(log,SetMuxInfo("         "));
+	}
+	//Set pointers
+	i = 0;
+	j = 0;
+	size = 5;
+}
+
+void H223Muxer::EndPDU()
+{
+	//Remove all empty sdus
+	H223MuxSDUMap::iterator it = sdus.begin();
+	while(it!=sdus.end())
+	{
+		//Get channel and sdu
+		int number		= it->first;
+		H223MuxSDU* sdu = it->second;
+		//If it's empty
+		if ((sdu!=NULL) && (sdu->Length()==0))
+		{
+			//Erase
+			sdus.erase(it++);
+			//Set event
+			senders[number]->OnPDUCompleted();
+			//Release our reference
+			sdu->Release();
+		} else
+			++it;
+	}
+}
+
 inline BYTE H223Muxer::Multiplex()
 {
 	//Multiplex
@@ -226,51 +497,8 @@ inline BYTE H223Muxer::Multiplex()
 		switch(state)
 		{
 			case NONE:
-				//Reset channel
-				channel = -1;
-				//If we have to finish last packet
-				if (!pm)
-				{
-					//Create the flag
-					buffer[0] = 0xE1;
-					buffer[1] = 0x4D;
-
-					//Log
-					log->SetMuxInfo("endflg");
-				} else {
-					//Create the flag
-					buffer[0] = (BYTE)~0xE1;
-					buffer[1] = (BYTE)~0x4D;
-					//Log
-					log->SetMuxInfo("dneflg");
-				}
-
-				//Get the best mc & mpl from the table
-				if (GetBestMC(160))
-				{
-					//Calculate p bits
-					WORD data = (mc & 0x0F) | mpl << 4;
-					//Get the codeword
-					long code = golay_encode(data);
-
-					//Create the header
-					buffer[2] = ((BYTE *)&code)[0];//(mc & 0x0F) | (mpl &0x0F) << 4;
-					buffer[3] = ((BYTE *)&code)[1];//(mpl &0xF0) >> 4;
-					buffer[4] = ((BYTE *)&code)[2];//0x00;
-					//Log
-					log->SetMuxInfo("   mc%.1d %.2x",mc,mpl);
-				} else {
-					//Create the header
-					buffer[2] = 0x00;
-					buffer[3] = 0x00;
-					buffer[4] = 0x00;
-					//Log
-					log->SetMuxInfo("         ");
-				}
-				//Set pointers
-				i = 0;
-				j = 0;
-				size = 5;
+				//Create flag and header of next pdu
+				BuildHeader();
 				//Send pdu
 				state = PDU;
 				break;
@@ -278,10 +506,12 @@ inline BYTE H223Muxer::Multiplex()
 				//If we still haven't sent the flag & header
 				if (i<size)
 				{
+					//Get header byte
+					BYTE b = buffer[i++];
 					//Log
-					log->SetMuxByte(buffer[i]);
-					//Return header byte
-					return buffer[i++];
+					TRACE(log,SetMuxByte(b));
+					//Return it with the output bit order
+					return reverse ? TIFFBitRevTable[b] : b;
 				}
 
 				//If we haven't finished
@@ -289,34 +519,21 @@ inline BYTE H223Muxer::Multiplex()
 				{
 					//Next channel byte
 					channel = table->GetChannel(mc,j++);
+					//Count, only the channels of the stats
+					if (channel>=0 && channel<16)
+						stats.channelBytes[channel]++;
 					//Get byte
 					BYTE b = sdus[channel]->Pop();
 					//Log
-					log->SetMuxByte(b);
-					log->SetMuxInfo(" c%.1d",channel);
-					//Send the byte
-					return b;
-				}
-				//Remove all empty sdus
-				{
-					H223MuxSDUMap::iterator it = sdus.begin();
-					while(it!=sdus.end())
-					{
-						//Get channel and sdu
-						int number		= it->first;
-						H223MuxSDU* sdu = it->second;
-						//If it's empty
-						if ((sdu!=NULL) && (sdu->Length()==0))
-						{
-							//Erase
-							sdus.erase(it++);
-							//Set event
-							senders[number]->OnPDUCompleted();
-						} else
-							++it;
-					}
+					TRACE(log,SetMuxByte(b));
+					TRACE(log,SetMuxInfo(" c%.1d",channel));
+					//Send the byte with the output bit order
+					return reverse ? TIFFBitRevTable[b] : b;
 				}
 
+				//End pdu
+				EndPDU();
+
 				//No state
 				state = NONE;
 				break;
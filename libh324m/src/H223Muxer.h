@@ -5,33 +5,58 @@
 #include "H223MuxTable.h"
 #include "H223MuxSDU.h"
 #include "H223AL.h"
-#include "log.h"
+#include "FileLogger.h"
 
 class H223Muxer
 {
 private:
 	typedef map<int,H223ALSender*> ALSendersMap;
 	typedef enum{NONE,PDU} State;
+public:
+	enum Policy
+	{
+		e_FillRatio	= 0,
+		e_AudioFirst	= 1,
+		e_Throughput	= 2
+	};
 public:
 	//Constructors
-	H223Muxer();
+	H223Muxer(TraceBuffer *trace = NULL);
 	~H223Muxer();
 
 	int Open(H223MuxTable *table);
 	int SetChannel(int num,H223ALSender *sender);
 	int ReleaseChannel(int num);
+	int SetPolicy(Policy policy);
+	int SetReverseBits(int reverse);
 	int  Multiplex(BYTE *buffer,int length);
 	BYTE Multiplex();
 	int Close();
 
+	//Counters
+	struct Stats
+	{
+		DWORD	bytes;
+		DWORD	pdus;
+		DWORD	stuffing;
+		//Only for logical channels 0 to 15
+		DWORD	channelBytes[16];
+	};
+	const Stats& GetStats()	{ return stats; }
+
 private:
 	int GetBestMC(int max);
+	void BuildHeader();
+	void EndPDU();
 
 private:
 	H223MuxTable* table;
 	H223MuxSDUMap sdus;
 	ALSendersMap  senders;
 	State state;
+	Policy policy;
+	WORD sduLen[256];
+	BYTE segmentable[256];
 
 	char buffer[5];
 	int mc;
@@ -42,8 +67,10 @@ private:
 	int size;
 	int len;
 	int channel;
+	int reverse;
+	Stats stats;
 
-	Logger *log;
+	FileLogger *log;
 
 };
 
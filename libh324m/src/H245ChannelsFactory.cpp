@@ -21,7 +21,7 @@
  */
 #include "H245ChannelsFactory.h"
 
-H245ChannelsFactory::H245ChannelsFactory()
+H245ChannelsFactory::H245ChannelsFactory() : muxer(&trace), demuxer(&trace,&profiler)
 {
 	//Set local capabilities only with layer 2
 	local.audioWithAL2 = true;
@@ -81,12 +81,16 @@ int H245ChannelsFactory::End()
 
 int H245ChannelsFactory::Demultiplex(BYTE *buffer,int length)
 {
+	//Profile
+	Profiler::Scope scope(&profiler,Profiler::e_Demux);
 	//DeMux
 	return demuxer.Demultiplex(buffer,length);
 }
 
 int H245ChannelsFactory::Multiplex(BYTE *buffer,int length)
 {
+	//Profile
+	Profiler::Scope scope(&profiler,Profiler::e_Mux);
 	//Mux
 	int ret = muxer.Multiplex(buffer,length);
 	//For all media channels
@@ -102,6 +106,80 @@ int H245ChannelsFactory::Multiplex(BYTE *buffer,int length)
 	return ret;
 }
 
+int H245ChannelsFactory::SetMuxPolicy(H223Muxer::Policy policy)
+{
+	//Set the mc selection policy of the muxer
+	return muxer.SetPolicy(policy);
+}
+
+int H245ChannelsFactory::SetReverseBits(int reverse)
+{
+	//Set the bit order of the input and output
+	demuxer.SetReverseBits(reverse);
+	return muxer.SetReverseBits(reverse);
+}
+
+H223MuxSDUPool* H245ChannelsFactory::GetSDUPool()
+{
+	//Return the sdu pool shared by the session
+	return &pool;
+}
+
+TraceBuffer* H245ChannelsFactory::GetTrace()
+{
+	//Return the trace buffer of the session
+	return &trace;
+}
+
+int H245ChannelsFactory::GetStats(H324MStats *stats)
+{
+	//Get mux and demux counters
+	const H223Muxer::Stats &mux = muxer.GetStats();
+	const H223Demuxer::Stats &demux = demuxer.GetStats();
+
+	//Set them
+	stats->bytesIn = demux.bytes;
+	stats->bytesOut = mux.bytes;
+	stats->pdusIn = demux.pdus;
+	stats->pdusOut = mux.pdus;
+	stats->stuffingIn = demux.stuffing;
+	stats->stuffingOut = mux.stuffing;
+	stats->resyncs = demux.resyncs;
+	stats->headerCorrected = demux.corrected;
+	stats->headerErrors = demux.errors;
+
+	//Control channel is always 0
+	stats->channels[STATS_CONTROL].bytesIn = demux.channelBytes[0];
+	stats->channels[STATS_CONTROL].bytesOut = mux.channelBytes[0];
+
+	//For each media channel
+	for (ChannelMap::iterator it = channels.begin(); it != channels.end(); ++it)
+	{
+		//Get channel
+		H324MMediaChannel *channel = it->second;
+		//Check for null
+		if (!channel)
+			continue;
+		//Get its stats
+		H324MChannelStats *chan = &stats->channels[channel->type==e_Audio ? STATS_AUDIO : STATS_VIDEO];
+		//Get the al counters
+		channel->GetStats(chan);
+		//And the bytes muxed and demuxed in its logical channels
+		if (channel->localChannel>0 && channel->localChannel<16)
+			chan->bytesOut = mux.channelBytes[channel->localChannel];
+		if (channel->remoteChannel>0 && channel->remoteChannel<16)
+			chan->bytesIn = demux.channelBytes[channel->remoteChannel];
+	}
+
+	return 1;
+}
+
+Profiler* H245ChannelsFactory::GetProfiler()
+{
+	//Return the stage profiler of the session
+	return &profiler;
+}
+
 int H245ChannelsFactory::CreateChannel(MediaType type)
 {
 	H324MMediaChannel* chan;
@@ -111,11 +189,11 @@ int H245ChannelsFactory::CreateChannel(MediaType type)
 	{
 		case e_Audio:
 			//New audio channel
-			chan = new H324MAudioChannel(25,160);
+			chan = new H324MAudioChannel(&pool,&trace,25,160);
 			break;
 		case e_Video:
 			//New audio channel
-			chan = new H324MVideoChannel();
+			chan = new H324MVideoChannel(&pool,&trace);
 			break;
 		default:
 			return -1;
@@ -297,6 +375,8 @@ int H245ChannelsFactory::OnMuxTableConfirm(H223MuxTableEntryList &list)
 
 Frame* H245ChannelsFactory::GetFrame()
 {
+	//Profile
+	Profiler::Scope scope(&profiler,Profiler::e_Frames);
 	//Loop throught channels
 	for (ChannelMap::iterator it = channels.begin(); it != channels.end(); it++)
 	{
@@ -319,6 +399,61 @@ Frame* H245ChannelsFactory::GetFrame()
 	return NULL;
 }
 
+int H245ChannelsFactory::GetFrames(Frame **frames,int max)
+{
+	//Profile
+	Profiler::Scope scope(&profiler,Profiler::e_Frames);
+	int num = 0;
+
+	//Loop throught channels
+	for (ChannelMap::iterator it = channels.begin(); it != channels.end() && num<max; it++)
+	{
+		//Get channel
+		H324MMediaChannel *channel = it->second;
+
+		//If have remote channel
+		if (channel->remoteChannel>0)
+			//Get all its frames that fit
+			num += channel->GetFrames(frames+num,max-num);
+	}
+
+	//Return number of frames
+	return num;
+}
+
+int H245ChannelsFactory::SendFrames(Frame **frames,int num)
+{
+	int sent = 0;
+
+	//Loop throught channels
+	for (ChannelMap::iterator it = channels.begin(); it != channels.end(); it++)
+	{
+		//Get channel
+		H324MMediaChannel *channel = it->second;
+
+		//If no local channel
+		if (channel->localChannel<=0)
+			//Next
+			continue;
+
+		//Send the frames of its type in order
+		for (int i=0;i<num;i++)
+		{
+			//If same type
+			if (frames[i]->type==channel->type)
+			{
+				//Send frame
+				channel->SendFrame(frames[i]);
+				//One more
+				sent++;
+			}
+		}
+	}
+
+	//Return the frames sent
+	return sent;
+}
+
 int H245ChannelsFactory::SendFrame(Frame* frame)
 {
 	//Loop throught channels
@@ -7,6 +7,9 @@
 #include "H324MMediaChannel.h"
 #include "H223Demuxer.h"
 #include "H223Muxer.h"
+#include "H223MuxSDUPool.h"
+#include "TraceBuffer.h"
+#include "Profiler.h"
 #include "H245Channel.h"
 #include "Media.h"
 #include <map>
@@ -44,6 +47,8 @@ public:
 
 	int Demultiplex(BYTE *buffer,int length);
 	int Multiplex(BYTE *buffer,int length);
+	int SetMuxPolicy(H223Muxer::Policy policy);
+	int SetReverseBits(int reverse);
 
 	int OnEstablishIndication(int number, H245Channel *channel);
 	int OnEstablishConfirm(int number);
@@ -52,9 +57,15 @@ public:
 	int OnMuxTableConfirm(H223MuxTableEntryList &list);
 
 	int GetRemoteChannel(MediaType type);
+	H223MuxSDUPool* GetSDUPool();
+	TraceBuffer* GetTrace();
+	Profiler* GetProfiler();
+	int GetStats(H324MStats *stats);
 
 	Frame* GetFrame();
+	int GetFrames(Frame **frames,int max);
 	int SendFrame(Frame *frame);
+	int SendFrames(Frame **frames,int num);
 
 private:
 	typedef std::map<int,H324MMediaChannel*> ChannelMap;
@@ -63,6 +74,9 @@ private:
 	H245Capabilities	remote;
 	H223MuxTable		localTable;
 	H223MuxTable		remoteTable;
+	TraceBuffer		trace;
+	Profiler		profiler;
+	H223MuxSDUPool		pool;
 	H223Muxer			muxer;
 	H223Demuxer			demuxer;
 	ChannelMap			channels;
@@ -1,6 +1,7 @@
 #ifndef _H245_CONNECTION_
 #define _H245_CONNECTION_
 #include "H324pdu.h"
+#include "Timer.h"
 
 class H245Connection 
 {
@@ -16,6 +17,21 @@ public:
 		e_MultiplexTable,
 		e_LogicalChannelRate
 	};
+
+	//Timers of the procedures
+	enum Timers
+	{
+		e_T101,		//Capability exchange
+		e_T102,		//Maintenance loop
+		e_T103,		//Uni-directional logical channel signalling
+		e_T104,		//H.223 multiplex table
+		e_T105,		//Round trip delay
+		e_T106,		//Master slave determination
+		e_T107,		//Request multiplex entry
+		e_T108,		//Bi-directional logical channel signalling
+		e_T109,		//Mode request
+		e_NumTimers
+	};
 	
 	//Events
 	struct Event
@@ -26,6 +42,9 @@ public:
 	virtual int WriteControlPDU(H324ControlPDU & pdu) = 0;
 	virtual int OnError(ControlProtocolSource source, const void *) = 0;
 	virtual int OnEvent(const Event& event) = 0;
+	virtual int OnTimeout(ControlProtocolSource source) = 0;
+	virtual Timer* GetTimer() = 0;
+	virtual DWORD GetTimeout(Timers timer) = 0;
 	/*
 	virtual int OnH245Request(H245_RequestMessage& req) = 0;
 	virtual int OnH245Response(H245_ResponseMessage& rep) = 0;
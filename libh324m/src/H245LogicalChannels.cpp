@@ -29,6 +29,35 @@ H245LogicalChannels::H245LogicalChannels(H245Connection & con)
 
 H245LogicalChannels::~H245LogicalChannels()
 {
+	//Delete all channel timers
+	for (TimerMap::iterator it = timers.begin(); it != timers.end(); it++)
+		//Delete
+		DestroyTimer(it->second);
+}
+
+void H245LogicalChannels::StartTimer(int channelNumber)
+{
+	//Find the timer of the channel
+	TimerMap::iterator it = timers.find(channelNumber);
+
+	//If it's the first time
+	if (it==timers.end())
+		//Create it with the channel number as id
+		it = timers.insert(TimerMap::value_type(channelNumber,CreateTimer(channelNumber))).first;
+
+	//Wait for response
+	H245Negotiator::StartTimer(it->second,H245Connection::e_T103);
+}
+
+void H245LogicalChannels::StopTimer(int channelNumber)
+{
+	//Find the timer of the channel
+	TimerMap::iterator it = timers.find(channelNumber);
+
+	//If found
+	if (it!=timers.end())
+		//Stop it
+		H245Negotiator::StopTimer(it->second);
 }
 
 /** Outgoing LCSE SDL
@@ -60,6 +89,8 @@ int H245LogicalChannels::EstablishRequest(int channelNumber,H245Channel & channe
 				return FALSE;
 			//Set state
 			out[channelNumber] = e_AwaitingEstablishment;
+			//Wait for the ack
+			StartTimer(channelNumber);
 			//Send pdu
   			return connection.WriteControlPDU(pdu);
 		}
@@ -79,6 +110,8 @@ int H245LogicalChannels::EstablishRequest(int channelNumber,H245Channel & channe
 				return FALSE;
 			//Set state
 			out[channelNumber] = e_AwaitingEstablishment;
+			//Wait for the ack
+			StartTimer(channelNumber);
 			//Send pdu
   			return connection.WriteControlPDU(pdu);
 		}
@@ -110,8 +143,10 @@ int H245LogicalChannels::ReleaseRequest(int channelNumber)
 		{
 			//Change state
 			out[channelNumber] = e_AwaitingRelease;
-			//H324ControlPDU pdu;
-			//H245_CloseLogicalChannel & open = pdu.BuildCloseLogicalChannel(channelNumber);
+			//Build close
+			pdu.BuildCloseLogicalChannel(channelNumber);
+			//Wait for the ack
+			StartTimer(channelNumber);
 			//Send pdu
   			return connection.WriteControlPDU(pdu);
 		}
@@ -119,8 +154,10 @@ int H245LogicalChannels::ReleaseRequest(int channelNumber)
 		{
 			//Change state
 			out[channelNumber] = e_AwaitingRelease;
-			//H324ControlPDU pdu;
-			//H245_CloseLogicalChannel & open = pdu.BuildCloseLogicalChannel(channelNumber);
+			//Build close
+			pdu.BuildCloseLogicalChannel(channelNumber);
+			//Wait for the ack
+			StartTimer(channelNumber);
 			//Send pdu
   			return connection.WriteControlPDU(pdu);
 		}
@@ -156,6 +193,8 @@ BOOL H245LogicalChannels::HandleOpenAck(const H245_OpenLogicalChannelAck & pdu)
 		case e_AwaitingEstablishment:
 			//Set state
 			out[channelNumber] = e_Established;
+			//Stop waiting
+			StopTimer(channelNumber);
 			//Send event
 			return connection.OnEvent(Event(e_EstablishConfirm,channelNumber));
 		case e_Established:
@@ -191,6 +230,8 @@ BOOL H245LogicalChannels::HandleReject(const H245_OpenLogicalChannelReject & pdu
 		case e_AwaitingEstablishment:
 			//Set state
 			out[channelNumber] = e_Released;
+			//Stop waiting
+			StopTimer(channelNumber);
 			//Send event
 			return connection.OnEvent(Event(e_ReleaseIndication,channelNumber));
 		case e_Established:
@@ -203,6 +244,8 @@ BOOL H245LogicalChannels::HandleReject(const H245_OpenLogicalChannelReject & pdu
 		case e_AwaitingRelease:
 			//Set state
 			out[channelNumber] = e_Released;
+			//Stop waiting
+			StopTimer(channelNumber);
 			//Send event
 			return connection.OnEvent(Event(e_ReleaseConfirm,channelNumber));
 	}
@@ -242,6 +285,8 @@ BOOL H245LogicalChannels::HandleCloseAck(const H245_CloseLogicalChannelAck & pdu
 		case e_AwaitingRelease:
 			//Set state
 			out[channelNumber] = e_Released;
+			//Stop waiting
+			StopTimer(channelNumber);
 			//Send event
 			return connection.OnEvent(Event(e_ReleaseConfirm,channelNumber));
 	}
@@ -250,6 +295,50 @@ BOOL H245LogicalChannels::HandleCloseAck(const H245_CloseLogicalChannelAck & pdu
 	return FALSE;
 }
 
+void H245LogicalChannels::OnTimeout(int channelNumber)
+{
+	Logger::Debug("H245 H245LogicalChannels timeout [%d]\n", channelNumber);
+
+	//Pdu
+	H324ControlPDU pdu;
+
+	//See if channel exist
+	if (out.find(channelNumber)==out.end())
+		//Exit
+		return;
+
+	//Check state
+	switch (out[channelNumber])
+	{
+		case e_AwaitingEstablishment:
+			//Close it
+			pdu.BuildCloseLogicalChannel(channelNumber);
+			//Send pdu
+			connection.WriteControlPDU(pdu);
+			//Set state
+			out[channelNumber] = e_Released;
+			//Send error
+			connection.OnEvent(Event(e_ErrorIndication,channelNumber));
+			//Send event
+			connection.OnEvent(Event(e_ReleaseIndication,channelNumber));
+			break;
+		case e_AwaitingRelease:
+			//Set state
+			out[channelNumber] = e_Released;
+			//Send error
+			connection.OnEvent(Event(e_ErrorIndication,channelNumber));
+			//Send event
+			connection.OnEvent(Event(e_ReleaseConfirm,channelNumber));
+			break;
+		default:
+			//Not waiting
+			return;
+	}
+
+	//Procedure failed
+	connection.OnTimeout(H245Connection::e_LogicalChannel);
+}
+
 /** Incomming LCSE SDL
 */
 int H245LogicalChannels::EstablishResponse(int channelNumber)
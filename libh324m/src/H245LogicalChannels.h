@@ -53,6 +53,9 @@ public:
     virtual BOOL HandleRequestCloseReject(const H245_RequestChannelCloseReject & pdu);
     virtual BOOL HandleRequestCloseRelease(const H245_RequestChannelCloseRelease & pdu);
 	*/
+protected:
+	virtual void OnTimeout(int channelNumber);
+
 private:
 	/** Channels
 	*/
@@ -64,10 +67,15 @@ private:
 	};
 
 	typedef std::map<int,States> StateMap;
+	typedef std::map<int,Timer::Handle> TimerMap;
+
+	void StartTimer(int channelNumber);
+	void StopTimer(int channelNumber);
 
 private:
 	StateMap out;
 	StateMap in;
+	TimerMap timers;
 };
 
 
@@ -24,16 +24,21 @@
 
 H245MasterSlave::H245MasterSlave(H245Connection &con):H245Negotiator(con) 
 {
-	//Initialize seed
-	srand(time(NULL));
+	//Initialize our own seed, different for sessions created at the same time
+	seed = (unsigned int)time(NULL) ^ (unsigned int)(unsigned long)this;
 
 	//Set initial values
 	state = e_Idle;
-	determinationNumber = 1 + (DWORD)(rand()*(0x1000000/(RAND_MAX+1.0)));
+	determinationNumber = Random();
 	terminalType = e_MCUOnly;
+
+	//Create T106 timer
+	t106 = CreateTimer();
 }
 
 H245MasterSlave::~H245MasterSlave() {
+	//Delete timer
+	DestroyTimer(t106);
 }
 
 BOOL H245MasterSlave::Request()
@@ -55,6 +60,9 @@ BOOL H245MasterSlave::Request()
 	//Build Master slave request
 	pdu.BuildMasterSlaveDetermination(terminalType, determinationNumber);
 
+	//Wait for response
+	StartTimer(t106,H245Connection::e_T106);
+
 	//Send
 	return connection.WriteControlPDU(pdu);
 }
@@ -81,6 +89,8 @@ BOOL H245MasterSlave::HandleIncoming(const H245_MasterSlaveDetermination & pdu)
 				status = newStatus;
 				//Incoming state
 				state = e_Incoming;
+				//Wait for ack
+				StartTimer(t106,H245Connection::e_T106);
 				//Build ACK
 				reply.BuildMasterSlaveDeterminationAck(newStatus==e_DeterminedMaster);				
 				//Send msg
@@ -108,6 +118,8 @@ BOOL H245MasterSlave::HandleIncoming(const H245_MasterSlaveDetermination & pdu)
 				status = newStatus;
 				//Incoming state
 				state = e_Incoming;
+				//Wait for ack
+				StartTimer(t106,H245Connection::e_T106);
 				//Build ACK
 				reply.BuildMasterSlaveDeterminationAck(newStatus==e_DeterminedMaster);				
 				//Send 
@@ -123,16 +135,20 @@ BOOL H245MasterSlave::HandleIncoming(const H245_MasterSlaveDetermination & pdu)
 					retryCount = 0;
 					//Idle
 					state = e_Idle;
+					//Stop waiting
+					StopTimer(t106);
 					//Error
 					return FALSE;
 				}
 
 				//Generate another rnd
-				determinationNumber = 1 + (DWORD)(rand()*(0x1000000/(RAND_MAX+1.0)));
+				determinationNumber = Random();
 				//Inc counter
 				retryCount++;
 				//Build Master slave request
 				reply.BuildMasterSlaveDetermination(terminalType, determinationNumber);
+				//Wait for response again
+				StartTimer(t106,H245Connection::e_T106);
 				//Send msg
 				connection.WriteControlPDU(reply);
 				//Send 
@@ -182,6 +198,9 @@ BOOL H245MasterSlave::HandleAck(const H245_MasterSlaveDeterminationAck & pdu)
 	//Return to idle
 	state = e_Idle;
 
+	//Stop waiting
+	StopTimer(t106);
+
 	//Exit
 	return TRUE;
 	
@@ -208,16 +227,20 @@ BOOL H245MasterSlave::HandleReject(const H245_MasterSlaveDeterminationReject & p
 				retryCount = 0;
 				//Idle
 				state = e_Idle;
+				//Stop waiting
+				StopTimer(t106);
 				//Error
 				return FALSE;
 			}
 
 			//Generate another rnd
-			determinationNumber = 1 + (DWORD)(rand()*(0x1000000/(RAND_MAX+1.0)));
+			determinationNumber = Random();
 			//Inc counter
 			retryCount++;
 			//Build Master slave request
 			reply.BuildMasterSlaveDetermination(terminalType, determinationNumber);
+			//Wait for response again
+			StartTimer(t106,H245Connection::e_T106);
 			//Send
 			return connection.WriteControlPDU(reply);
 		case e_Incoming:
@@ -239,9 +262,43 @@ BOOL H245MasterSlave::HandleRelease(const H245_MasterSlaveDeterminationRelease &
 
 	state = e_Idle;
 
+	//Stop waiting
+	StopTimer(t106);
+
 	return connection.OnError(H245Connection::e_MasterSlaveDetermination,"Aborted");
 }
 
+void H245MasterSlave::OnTimeout(int id)
+{
+	Logger::Debug("H245 MasterSlaveDetermination timeout\n");
+
+	//If we were not waiting
+	if (state == e_Idle)
+		return;
+
+	//If we sent the request
+	if (state == e_Outgoing)
+	{
+		H324ControlPDU pdu;
+		//Build release
+		pdu.Build(H245_IndicationMessage::e_masterSlaveDeterminationRelease);
+		//Send it
+		connection.WriteControlPDU(pdu);
+	}
+
+	//Return to idle
+	state = e_Idle;
+
+	//Procedure failed
+	connection.OnTimeout(H245Connection::e_MasterSlaveDetermination);
+}
+
+DWORD H245MasterSlave::Random()
+{
+	//Get a 24 bits number without touching the global rand state
+	return 1 + (DWORD)(rand_r(&seed)*(0x1000000/(RAND_MAX+1.0)));
+}
+
 H245MasterSlave::MasterSlaveStatus H245MasterSlave::getStatus() 
 {
 	return status;
@@ -69,6 +69,10 @@ public:
 	BOOL HandleRelease(const H245_MasterSlaveDeterminationRelease & pdu);
 	
 	MasterSlaveStatus getStatus();
+
+protected:
+	virtual void OnTimeout(int id);
+
 private:
 	enum States {
 		e_Idle, 
@@ -77,12 +81,15 @@ private:
 	};
 
 	MasterSlaveStatus	DetermineStatus(DWORD type,DWORD number);
+	DWORD			Random();
 
 	DWORD				determinationNumber;
 	TerminalTypes		terminalType;
 	unsigned			retryCount;
 	MasterSlaveStatus	status;
 	States				state;
+	Timer::Handle		t106;
+	unsigned int		seed;
 
 };
 
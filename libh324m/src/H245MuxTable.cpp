@@ -32,10 +32,15 @@ H245MuxTable::H245MuxTable(H245Connection & con)
 	//Initial secuence number
 	inSec = (unsigned)-1;
 	outSec = 0;
+
+	//Create T104 timer
+	t104 = CreateTimer();
 }
 
 H245MuxTable::~H245MuxTable()
 {
+	//Delete timer
+	DestroyTimer(t104);
 }
 
 /* Outgoing MTSE SDL
@@ -44,9 +49,6 @@ BOOL H245MuxTable::TransferRequest(H223MuxTable& table)
 {
 	Logger::Debug("H245 MultiplexEntrySend\n");
 
-	//If not in idle
-		//Reset timer
-
 	//Increment secuence number
 	outSec = (outSec + 1)%256;
 
@@ -61,7 +63,16 @@ BOOL H245MuxTable::TransferRequest(H223MuxTable& table)
 	//Create pdu
 	table.BuildPDU(entrySend);
 
-	//Set timer
+	//Save the entries sent in case we have to release them
+	outEntries.clear();
+
+	//For all entries
+	for (int i=0; i<entrySend.m_multiplexEntryDescriptors.GetSize(); i++)
+		//Append to list
+		outEntries.push_back(entrySend.m_multiplexEntryDescriptors[i].m_multiplexTableEntryNumber.GetValue());
+
+	//Set timer, restarted if there was one already pending
+	StartTimer(t104,H245Connection::e_T104);
 
 	//Write pdu
 	return connection.WriteControlPDU(pdu);
@@ -82,6 +93,7 @@ BOOL H245MuxTable::HandleAck(const H245_MultiplexEntrySendAck  & pdu)
 		return TRUE;
 
 	//Reset timer
+	StopTimer(t104);
 
 	//Set state
 	outState = e_Idle;
@@ -112,6 +124,7 @@ BOOL H245MuxTable::HandleReject(const H245_MultiplexEntrySendReject & pdu)
 		return TRUE;
 
 	//Reset timer
+	StopTimer(t104);
 
 	//Set state
 	outState = e_Idle;
@@ -128,6 +141,43 @@ BOOL H245MuxTable::HandleReject(const H245_MultiplexEntrySendReject & pdu)
 	return connection.OnEvent(Event(e_TransferReject,NULL,&list));
 }
 
+void H245MuxTable::OnTimeout(int id)
+{
+	Logger::Debug("H245 MultiplexEntrySend timeout\n");
+
+	//If not waiting
+	if (outState==e_Idle)
+		return;
+
+	H324ControlPDU pdu;
+
+	//Build release
+	H245_MultiplexEntrySendRelease &release = pdu.Build(H245_IndicationMessage::e_multiplexEntrySendRelease);
+
+	//Take out all
+	release.m_multiplexTableEntryNumber.RemoveAll();
+
+	//Release the entries we were sending
+	for (H223MuxTableEntryList::iterator it = outEntries.begin(); it != outEntries.end(); it++)
+	{
+		//Create entry number
+		H245_MultiplexTableEntryNumber number;
+		//Set the value
+		number.SetValue(*it);
+		//Append to array
+		release.m_multiplexTableEntryNumber.Append((PASN_Object*)number.Clone());
+	}
+
+	//Write
+	connection.WriteControlPDU(pdu);
+
+	//Set state
+	outState = e_Idle;
+
+	//Procedure failed
+	connection.OnTimeout(H245Connection::e_MultiplexTable);
+}
+
 /*
  * Incoming MTSE SDL
  */
@@ -34,7 +34,7 @@ public:
 
 public:
 	H245MuxTable(H245Connection & connection);
-	~H245MuxTable();
+	virtual ~H245MuxTable();
 
 	BOOL TransferRequest(H223MuxTable &table);
 	BOOL TransferResponse(H223MuxTableEntryList &accept);
@@ -44,6 +44,9 @@ public:
     BOOL HandleAck(const H245_MultiplexEntrySendAck  & pdu);
 	BOOL HandleReject(const H245_MultiplexEntrySendReject & pdu);
 
+protected:
+	virtual void OnTimeout(int id);
+
 private:
 	enum States{
 		e_Idle,
@@ -55,6 +58,9 @@ private:
 
     unsigned      inSec;
     unsigned      outSec;
+
+	H223MuxTableEntryList outEntries;
+	Timer::Handle t104;
 };
 
 #endif
@@ -28,3 +28,33 @@ H245Negotiator::H245Negotiator(H245Connection &con) : connection(con)
 H245Negotiator::~H245Negotiator()
 {
 }
+
+Timer::Handle H245Negotiator::CreateTimer(int id)
+{
+	//Create it in the connection wheel
+	return connection.GetTimer()->CreateTimer(OnTimer,this,id);
+}
+
+void H245Negotiator::StartTimer(Timer::Handle timer,H245Connection::Timers which)
+{
+	//Set it with the connection timeout
+	connection.GetTimer()->SetTimer(timer,connection.GetTimeout(which));
+}
+
+void H245Negotiator::StopTimer(Timer::Handle timer)
+{
+	//Reset it
+	connection.GetTimer()->ResetTimer(timer);
+}
+
+void H245Negotiator::DestroyTimer(Timer::Handle timer)
+{
+	//Delete it
+	connection.GetTimer()->DestroyTimer(timer);
+}
+
+void H245Negotiator::OnTimer(void *negotiator,int id)
+{
+	//Launch event
+	((H245Negotiator*)negotiator)->OnTimeout(id);
+}
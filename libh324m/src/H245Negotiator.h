@@ -7,7 +7,20 @@ class H245Negotiator
 {
 public:
 	H245Negotiator(H245Connection &con);
-	~H245Negotiator();
+	virtual ~H245Negotiator();
+
+protected:
+	//Procedure timers from the connection wheel, id tells them apart
+	Timer::Handle CreateTimer(int id = 0);
+	void StartTimer(Timer::Handle timer,H245Connection::Timers which);
+	void StopTimer(Timer::Handle timer);
+	void DestroyTimer(Timer::Handle timer);
+
+	//Called when a timer expires
+	virtual void OnTimeout(int id) {}
+
+private:
+	static void OnTimer(void *negotiator,int id);
 
 protected:
 	H245Connection &connection;
@@ -15,4 +28,3 @@ protected:
 
 
 #endif
-
@@ -27,10 +27,14 @@ H245RoundTripDelay::H245RoundTripDelay(H245Connection & con)
 {
 	awaitingResponse = FALSE;
 	sequenceNumber = 0;
+	//Create T105 timer
+	t105 = CreateTimer();
 }
 
 H245RoundTripDelay::~H245RoundTripDelay()
 {
+	//Delete timer
+	DestroyTimer(t105);
 }
 
 BOOL H245RoundTripDelay::Start()
@@ -44,6 +48,9 @@ BOOL H245RoundTripDelay::Start()
 
 	pdu.BuildRoundTripDelayRequest(sequenceNumber);
 
+	//Wait for response
+	StartTimer(t105,H245Connection::e_T105);
+
 	if (!connection.WriteControlPDU(pdu))
 		return FALSE;
 
@@ -70,9 +77,27 @@ BOOL H245RoundTripDelay::HandleResponse(const H245_RoundTripDelayResponse & pdu)
 	{
 		awaitingResponse = FALSE;
 
+		//Stop waiting
+		StopTimer(t105);
+
 		//Set event
 		connection.OnEvent(Event());
 	}
 
 	return TRUE;
 }
+
+void H245RoundTripDelay::OnTimeout(int id)
+{
+	Logger::Debug("H245 Round trip delay timeout\n");
+
+	//If not waiting
+	if (!awaitingResponse)
+		return;
+
+	//Not waiting anymore
+	awaitingResponse = FALSE;
+
+	//The remote end is not responding
+	connection.OnTimeout(H245Connection::e_RoundTripDelay);
+}
@@ -26,9 +26,13 @@ public:
 	BOOL HandleRequest(const H245_RoundTripDelayRequest & pdu);
 	BOOL HandleResponse(const H245_RoundTripDelayResponse & pdu);
 
+protected:
+	virtual void OnTimeout(int id);
+
 protected:
 	BOOL          awaitingResponse;
 	unsigned      sequenceNumber;
+	Timer::Handle t105;
 };
 
 #endif
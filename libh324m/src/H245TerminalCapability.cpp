@@ -33,9 +33,14 @@ H245TerminalCapability::H245TerminalCapability(H245Connection & con)
 	//Idle state
 	inState = e_Idle;
 	outState = e_Idle;
+
+	//Create T101 timer
+	t101 = CreateTimer();
 }
 
 H245TerminalCapability::~H245TerminalCapability() {
+	//Delete timer
+	DestroyTimer(t101);
 }
 
 /** Outgoing CESE SDL
@@ -62,6 +67,9 @@ BOOL H245TerminalCapability::TransferRequest(H245Capabilities* capabilities)
 	//Set capabilites
 	capabilities->BuildPDU(pdu.BuildTerminalCapabilitySet(outSequenceNumber));
 
+	//Wait for response
+	StartTimer(t101,H245Connection::e_T101);
+
 	//Write pdu
 	return connection.WriteControlPDU(pdu);
 }
@@ -83,6 +91,9 @@ BOOL H245TerminalCapability::HandleAck(const H245_TerminalCapabilitySetAck & pdu
 	//Reset state
  	outState = e_Idle;
 
+	//Stop waiting
+	StopTimer(t101);
+
 	//Event
 	return connection.OnEvent(Event(e_TransferConfirm,NULL));
 }
@@ -104,6 +115,9 @@ BOOL H245TerminalCapability::HandleReject(const H245_TerminalCapabilitySetReject
 	//Reset state
  	outState = e_Idle;
 
+	//Stop waiting
+	StopTimer(t101);
+
 	//Event
 	return connection.OnEvent(Event(e_RejectIndication,NULL));;
 }
@@ -164,5 +178,32 @@ BOOL H245TerminalCapability::HandleRelease(const H245_TerminalCapabilitySetRelea
 	//Reset state
 	outState = e_Idle;
 
+	//Stop waiting
+	StopTimer(t101);
+
 	return connection.OnEvent(Event(e_RejectIndication,NULL));
 }
+
+void H245TerminalCapability::OnTimeout(int id)
+{
+	Logger::Debug("H245 TerminalCapabilitySet timeout\n");
+
+	//If not waiting
+	if (outState == e_Idle)
+		return;
+
+	//Reply
+	H324ControlPDU pdu;
+
+	//Build release
+	pdu.Build(H245_IndicationMessage::e_terminalCapabilitySetRelease);
+
+	//Send it
+	connection.WriteControlPDU(pdu);
+
+	//Reset state
+	outState = e_Idle;
+
+	//Procedure failed
+	connection.OnTimeout(H245Connection::e_CapabilityExchange);
+}
@@ -44,6 +44,9 @@ public:
 	BOOL HandleReject(const H245_TerminalCapabilitySetReject & pdu);
 	BOOL HandleRelease(const H245_TerminalCapabilitySetRelease & pdu);
 
+protected:
+	virtual void OnTimeout(int id);
+
 private:
 	/** Process state
 	*/
@@ -57,6 +60,7 @@ private:
 	DWORD	outSequenceNumber;
 	States	inState;
 	States	outState;
+	Timer::Handle t101;
 };
 
 
@@ -19,32 +19,53 @@
  * along with this program; if not, write to the Free Software
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
  */
-#include <iostream>
-#include <fstream>
+#include <stdlib.h>
 #include "H324CCSRLayer.h"
 #include "crc16.h"
+#include "bits.h"
 #include "log.h"
 
 #define SRP_SRP_COMMAND 249
 #define SRP_SRP_RESPONSE 251
 #define SRP_NSRP_RESPONSE 247
 
+//Default retransmission timer, retries and outstanding commands
+#define SRP_T401	400
+#define SRP_N400	10
+#define SRP_WINDOW	1
 
-H324CCSRLayer::H324CCSRLayer() : sdu(255),ccsrl(255)
+//Max size of a segmented pdu, bigger ones are dropped
+#define CCSRL_MAX_PDU	65536
+
+
+H324CCSRLayer::H324CCSRLayer(H223MuxSDUPool *sduPool,Timer *sessionTimer,TraceBuffer *trace,Profiler *sessionProfiler) : sdu(255)
 {
+	//Store sdu pool
+	pool = sduPool;
+	//Store timer wheel
+	timer = sessionTimer;
+	//Store session profiler
+	profiler = sessionProfiler;
 	//Initialize variables
 	lastsn = 0xFF;
 	sentsn = 0;
-	cmdsn = 0xFF;
-	cmd = NULL;
-	waiting = false;
-	isPDU = false;
-
-	std::fstream flog;
-
-	flog.open ("h245.log",ios::out|ios::app);
-	flog << "****\r\n-Init call\r\n";
-	flog.close();
+	cmdsn = 0;
+	isCmd = false;
+	//Nothing to reassemble yet
+	ccsrl = NULL;
+	ccsrlLen = 0;
+	ccsrlSize = 0;
+	ccsrlDrop = false;
+	//No counters
+	memset(&stats,0,sizeof(stats));
+	//Plain SRP, one command at a time
+	t401 = SRP_T401;
+	n400 = SRP_N400;
+	window = SRP_WINDOW;
+	//Create logger
+	logger = new FileLogger(trace);
+	//Log
+	logger->SetH245Event("Init call");
 
 	//Begin stream encoding
 	strm.BeginEncoding();
@@ -52,6 +73,38 @@ H324CCSRLayer::H324CCSRLayer() : sdu(255),ccsrl(255)
 
 H324CCSRLayer::~H324CCSRLayer()
 {
+	//Release commands waiting for response
+	while(outstanding.size()>0)
+	{
+		//Release front
+		ReleaseCommand(outstanding.front());
+		//Remove
+		outstanding.pop_front();
+	}
+
+	//Release pending commands
+	while(cmds.size()>0)
+	{
+		//Release front
+		cmds.front()->Release();
+		//Remove
+		cmds.pop_front();
+	}
+
+	//Release pending replies
+	while(rpls.size()>0)
+	{
+		//Release front
+		rpls.front()->Release();
+		//Remove
+		rpls.pop_front();
+	}
+
+	//Free reassembly buffer
+	free(ccsrl);
+
+	//Delete logger
+	delete logger;
 }
 
 void H324CCSRLayer::Send(BYTE b)
@@ -60,16 +113,33 @@ void H324CCSRLayer::Send(BYTE b)
 	sdu.SetAt(sdu.GetSize(),b);
 }
 
+void H324CCSRLayer::Send(const BYTE *buffer,int len)
+{
+	//Get current size
+	PINDEX size = sdu.GetSize();
+
+	//Grow stream and append data
+	memcpy(sdu.GetPointer(size+len)+size,buffer,len);
+}
+
+void H324CCSRLayer::SendReversed(const BYTE *buffer,int len)
+{
+	//Get current size
+	PINDEX size = sdu.GetSize();
+
+	//Grow stream and append data with the bits in order
+	TIFFReverseBitsCopy(sdu.GetPointer(size+len)+size,buffer,len);
+}
+
 void H324CCSRLayer::SendClosingFlag()
 {
 	//Check minimum length
 	if (sdu.GetSize()<3)
 		return;
 
-	//Log
-	std::fstream flog;
-	flog.open ("h245.log",ios::out|ios::app);
-	flog << "-SendClosingFlag\r\n";
+	//The srp and h245 processing is charged to the control
+	Profiler::Scope scope(profiler,Profiler::e_Control);
+
 	//The header
 	BYTE header = sdu[0];
 
@@ -94,10 +164,14 @@ void H324CCSRLayer::SendClosingFlag()
 	//Check it's good crc
 	if (crcA!=crcB)
 	{
-		flog << "BAD CRC\n";
+		logger->SetH245Event("Bad CRC");
+		stats.crcErrors++;
 		goto clean;
 	}
 
+	//One more
+	stats.received++;
+
 	//Depending on the type
 	switch(header)
 	{
@@ -110,14 +184,15 @@ void H324CCSRLayer::SendClosingFlag()
 			sn = sdu[1];
 
 			Logger::Debug("Received SRP_SRP_COMMAND [%d]\n",sn);
-			flog << "SRP_SRP_COMMAND\n";
+			logger->SetH245Event("SRP_SRP_COMMAND [%d]",sn);
 			//Send NSRP Response
 			SendNSRP(sn);
 
 			//Check for retransmission
 			if (sn == lastsn)
 			{
-				flog << "Retransmission\n";
+				logger->SetH245Event("Retransmission [%d]",sn);
+				stats.duplicates++;
 				goto clean;
 			}
 
@@ -127,59 +202,78 @@ void H324CCSRLayer::SendClosingFlag()
 			//Get he ccsrl header
 			lsField = sdu[2];
 
-			//Encue the sdu to the ccsrl stream
-			ccsrl.Concatenate(PBYTEArray(sdu.GetPointer()+3,sdu.GetSize()-5));
+			//If we are dropping a pdu
+			if (ccsrlDrop)
+			{
+				//Until its last segment
+				if (lsField)
+					ccsrlDrop = false;
+				break;
+			}
 
-			//If it's the last ccsrl sdu
-			if (lsField)
+			//If it's a whole pdu and there is nothing pending
+			if (lsField && !ccsrlLen)
 			{
-				//Decode
-				H324ControlPDU pdu;
-	
-				//Decode
-				while (!ccsrl.IsAtEnd() && pdu.Decode(ccsrl))
+				//Decode it from the sdu itself
+				DecodePDUs(sdu.GetPointer()+3,sdu.GetSize()-5);
+				break;
+			}
+
+			//Check there is room for the segment
+			if (ccsrlLen+sdu.GetSize()-5>ccsrlSize)
+			{
+				//Grow, it's kept for the next ones
+				DWORD size = (ccsrlLen+sdu.GetSize()-5)*2;
+				BYTE *grown = NULL;
+				//If it's not too big
+				if (ccsrlLen+sdu.GetSize()-5<=CCSRL_MAX_PDU)
+					grown = (BYTE*)realloc(ccsrl,size);
+				//Check
+				if (!grown)
 				{
-					//Launch event
-					OnControlPDU(pdu);
-					
-					//Byte aling the stream
-					ccsrl.ByteAlign();
-
-					//Log
-					pdu.PrintOn(flog);
-					flog << "\r\n";
+					Logger::Error("-Dropping CCSRL pdu of more than %d bytes\n",ccsrlLen);
+					logger->SetH245Event("Dropping CCSRL pdu");
+					//Reset
+					ccsrlLen = 0;
+					//Drop the rest of its segments
+					ccsrlDrop = !lsField;
+					break;
 				}
+				//Set new one
+				ccsrl = grown;
+				ccsrlSize = size;
+			}
 
-				//Reset the decoder just if something went wrong
-				ccsrl.ResetDecoder();
+			//Append the segment
+			memcpy(ccsrl+ccsrlLen,sdu.GetPointer()+3,sdu.GetSize()-5);
+			ccsrlLen += sdu.GetSize()-5;
 
+			//If it's the last ccsrl sdu
+			if (lsField)
+			{
+				//Decode the whole pdu
+				DecodePDUs(ccsrl,ccsrlLen);
 				//Clean 
-				ccsrl.SetSize(0);
+				ccsrlLen = 0;
 			}
 			break;
 		case SRP_NSRP_RESPONSE:
-			//Check nsrp field
-			if (sdu[1]==cmdsn)
-			{
-				Logger::Debug("Received SRP_NSRP_RESPONSE [%d]\n",sdu[1]);
-				flog << "SRP_NSRP_RESPONSE\n";
-				//End waiting
-				waiting = false;
-			} else
-				Logger::Debug("Received out of order SRP_NSRP_RESPONSE [%d]\n",sdu[1]);
+			Logger::Debug("Received SRP_NSRP_RESPONSE [%d]\n",sdu[1]);
+			logger->SetH245Event("SRP_NSRP_RESPONSE [%d]",sdu[1]);
+			//Acknowledge the command with that sn
+			OnResponse(sdu[1]);
 			break;
 		case SRP_SRP_RESPONSE:
 			Logger::Debug("Received SRP_SRP_RESPONSE\n");
-			flog << "SRP_RESPONSE\n";
-			//End waiting
-			waiting = false;
+			logger->SetH245Event("SRP_SRP_RESPONSE");
+			//Acknowledge the oldest command
+			OnResponse(-1);
 			break;
 	}
 
 clean:
 	//Clean sdu
 	sdu.SetSize(0);
-	flog.close();
 }
 
 
@@ -204,7 +298,10 @@ void H324CCSRLayer::SendNSRP(BYTE sn)
 	WORD c = crc.Calc();
 	
 	//Create the SDU
-	H223MuxSDU* rpl = new H223MuxSDU(header,2);
+	H223MuxSDU* rpl = pool->Create(4);
+
+	//Add header
+	rpl->Push(header,2);
 
 	//Add crc
 	rpl->Push(((BYTE*)&c)[0]);
@@ -216,27 +313,66 @@ void H324CCSRLayer::SendNSRP(BYTE sn)
 
 void H324CCSRLayer::SendPDU(H324ControlPDU &pdu)
 {
+	//Log it before encoding if enabled
+	if (logger->IsLoggingH245())
+	{
+		PStringStream text;
+		pdu.PrintOn(text);
+		logger->DumpH245Output(text,text.GetLength());
+	}
+
 	//Encode pdu
 	pdu.Encode(strm);
-	//Set flag
-	isPDU = true;
+
+	//Finish encoding
+	strm.CompleteEncoding();
 
 	Logger::Debug("Encode PDU [%d]\n",strm.GetSize());
 
-	BuildCMD();
+	//Send it
+	BuildCMD(strm.GetPointer(),strm.GetSize());
+
+	//Clean stream
+	strm.SetSize(0);
+
+	//Begin encoding
+	strm.BeginEncoding();
 }
 
-void H324CCSRLayer::BuildCMD()
+/**********************************
+* DecodePDUs
+*	Decodes the pdus of a complete CCSRL sdu from the buffer. The
+*	buffer is wrapped, not copied, so it must outlive the stream.
+***********************************/
+void H324CCSRLayer::DecodePDUs(const BYTE *buffer,DWORD len)
 {
-	//If it's not empty
-	if (!isPDU)
-		return;
+	//Wrap the buffer without allocating a copy
+	PBYTEArray data(buffer,len,FALSE);
+	//Decode from it, the stream shares the array
+	PPER_Stream pdus(data);
+	H324ControlPDU pdu;
+
+	//Decode
+	while (!pdus.IsAtEnd() && pdu.Decode(pdus))
+	{
+		//Launch event
+		OnControlPDU(pdu);
 
-	//Finish encoding
-	strm.CompleteEncoding();
+		//Byte aling the stream
+		pdus.ByteAlign();
+
+		//Log it if enabled, it's already decoded
+		if (logger->IsLoggingH245())
+		{
+			PStringStream text;
+			pdu.PrintOn(text);
+			logger->DumpH245Input(text,text.GetLength());
+		}
+	}
+}
 
-	//Get the h245 encoded length
-	int pduLen = strm.GetSize();
+void H324CCSRLayer::BuildCMD(const BYTE *pdu,int pduLen)
+{
 	int len = 0;
 	int packetLen = 0;
 
@@ -268,7 +404,10 @@ void H324CCSRLayer::BuildCMD()
 		header[1] = sentsn++;
 
 		//Create the SDU
-		H223MuxSDU* cmd = new H223MuxSDU(header,2);
+		H223MuxSDU* cmd = pool->Create(packetLen+5);
+
+		//Add header
+		cmd->Push(header,2);
 
 		//Calculate checksum
 		CRC16 crc;
@@ -283,10 +422,10 @@ void H324CCSRLayer::BuildCMD()
 		crc.Add(lsField);
 
 		//Append payload to sdu
-		cmd->Push(strm.GetPointer()+len,packetLen);
+		cmd->Push(pdu+len,packetLen);
 
 		//Append payload to crc
-		crc.Add(strm.GetPointer()+len,packetLen);
+		crc.Add(pdu+len,packetLen);
 
 		//Get the crc
 		WORD c = crc.Calc();
@@ -301,17 +440,62 @@ void H324CCSRLayer::BuildCMD()
 		//Increment length
 		len +=packetLen;
 	}
+}
 
-	//Clean stream
-	strm.SetSize(0);
+void H324CCSRLayer::SetRetransmission(DWORD t401,int n400,int window)
+{
+	//Store values
+	this->t401 = t401;
+	this->n400 = n400;
+	//At least one command and less than half the sequence numbers
+	this->window = window<1 ? 1 : window>128 ? 128 : window;
+}
 
-	//No cmd
-	isPDU = false;
+void H324CCSRLayer::OnT401(void *data,int id)
+{
+	//Retransmitted on next GetNextPDU
+	((Command*)data)->expired = true;
+}
 
-	//Begin encoding
-	strm.BeginEncoding();
+void H324CCSRLayer::ReleaseCommand(Command &cmd)
+{
+	//Stop T401
+	if (cmd.t401)
+		timer->DestroyTimer(cmd.t401);
+
+	//Release it, the muxer has its own reference if it's sending it
+	cmd.sdu->Release();
+}
+
+void H324CCSRLayer::OnResponse(int sn)
+{
+	//Search the command
+	for (Commands::iterator it=outstanding.begin();it!=outstanding.end();++it)
+	{
+		//If it's not the one acknowledged
+		if (sn!=-1 && it->sn!=sn)
+			continue;
+
+		//Release it
+		ReleaseCommand(*it);
+
+		//Remove
+		outstanding.erase(it);
+
+		//Exit
+		return;
+	}
+
+	Logger::Debug("Response for unknown CMD [%d]\n",sn);
 }
 
+/**********************************
+* GetNextPDU
+*	Replies go first. Then the first command whose T401 timer has
+*	expired is retransmitted, or dropped after N400 retries. If none
+*	and there is room in the window a new command is sent. T401 runs
+*	on the session timer wheel so it follows the session clock.
+***********************************/
 H223MuxSDU* H324CCSRLayer::GetNextPDU()
 {
 	//No cmd
@@ -324,96 +508,126 @@ H223MuxSDU* H324CCSRLayer::GetNextPDU()
 	//It's a cmd
 	isCmd = true;
 
-	//Still waiting for reply?
-	if (!waiting)
+	//Check commands waiting for response
+	Commands::iterator it = outstanding.begin();
+
+	while (it!=outstanding.end())
 	{
-		//Got response so delete
-		if (cmd!=NULL)
+		//If it's still being sent or the timer has not expired
+		if (it->sending || !it->expired)
 		{
-			//Delete
-			delete cmd;
-			//No comand
-			cmd = NULL;
+			//Next
+			++it;
+			continue;
 		}
-		
-		//If we don't have elements
-		if (cmds.size()==0)
-			return NULL;
 
-		//Get first command
-		cmd = cmds.front();
+		//If we have retried too much
+		if (it->retries>=n400)
+		{
+			Logger::Error("-CMD [%d] not acknowledged after %d retries\n",it->sn,it->retries);
+			//Log
+			logger->SetH245Event("Dropping CMD [%d]",it->sn);
+			//Release
+			ReleaseCommand(*it);
+			//Count
+			stats.dropped++;
+			//Remove and next
+			outstanding.erase(it++);
+			continue;
+		}
 
-		//Remove
-		cmds.pop_front();	
+		//Retransmit from the begining
+		it->sdu->Begin();
+		it->retries++;
+		it->sending = true;
+		it->expired = false;
+		//Count
+		stats.retransmissions++;
+		//Sending it
+		cmdsn = it->sn;
+		//Log
+		logger->SetH245Event("Retransmitting CMD [%d]",it->sn);
+		//Return cmd
+		return it->sdu;
+	}
 
-		//Update last sequence numbar
-		cmdsn = (cmdsn+1)%256;
+	//If the window is full or we don't have elements
+	if ((int)outstanding.size()>=window || cmds.size()==0)
+		return NULL;
 
-		//Sending cmd
-		Logger::Debug("Sending CMD [%d] - %d left\n",cmdsn,cmds.size());
-		{
-			
-			PPER_Stream aux;
-			aux.Concatenate(PBYTEArray(cmd->GetPointer()+3,cmd->Length()-5));
-
-			//Decode
-			H324ControlPDU pdu;
-			
-			fstream log;
-			//log.open ("c:\\logs\\h245.txt",ios::out|ios::app);
-			log.open ("h245.log",ios::out|ios::app);
-			log << "-Sending\n";
-			//Decode
-			while (!aux.IsAtEnd() && pdu.Decode(aux))
-			{
-				pdu.PrintOn(log);
-				log << "\r\n";
-			}
+	//Get first command
+	Command cmd;
+	cmd.sdu = cmds.front();
+	cmd.sn = cmd.sdu->GetPointer()[1];
+	cmd.t401 = NULL;
+	cmd.expired = false;
+	cmd.retries = 0;
+	cmd.sending = true;
 
-			log.close();
-		}
+	//Remove
+	cmds.pop_front();
 
-		//Wait for reply
-		waiting = false;
+	//Wait for its response
+	outstanding.push_back(cmd);
 
-		//Reset counter
-		counter = 0;
+	//Create its T401, the list doesn't move it
+	if (timer)
+		outstanding.back().t401 = timer->CreateTimer(OnT401,&outstanding.back());
 
-	} else{
-		//Still waiting for repsonse
-		if (counter++<20)
-			//Wait for at least 20 to retransmit
-			return NULL;
+	//One more
+	stats.commands++;
 
-		//Reset counter
-		counter = 0;
+	//Sending it
+	cmdsn = cmd.sn;
 
-		//Retransmit
-		cmd->Begin();
+	//Sending cmd
+	Logger::Debug("Sending CMD [%d] - %d left\n",cmdsn,cmds.size());
 
-		//Logger::Debug("-Send retry CMD\n");
-	}
-	
 	//Return cmd
-	return cmd;
+	return cmd.sdu;
 }
 
 void H324CCSRLayer::OnPDUCompleted()
 {
+	//Sent
+	stats.sent++;
+
 	//If it was response
 	if (!isCmd)
 	{
-		//Delete the first element
-		delete rpls.front();
+		//Release the first element
+		rpls.front()->Release();
 
 		//Remove
 		rpls.pop_front();
-	} else {
-		//Wait for response to delete
-		waiting = true;
+		//Exit
+		return;
+	}
+
+	//Search the command sent, it could have been acknowledged meanwhile
+	for (Commands::iterator it=outstanding.begin();it!=outstanding.end();++it)
+	{
+		//If it's the one
+		if (it->sn==cmdsn)
+		{
+			//Start T401 now that it's completely sent
+			if (it->t401)
+				timer->SetTimer(it->t401,t401);
+			it->sending = false;
+			//Exit
+			return;
+		}
 	}
 }
 
+const H324CCSRLayer::Stats& H324CCSRLayer::GetStats()
+{
+	//Commands not acknowledged yet
+	stats.queued = cmds.size()+outstanding.size();
+	//Return them
+	return stats;
+}
+
 int H324CCSRLayer::OnControlPDU(H324ControlPDU &pdu)
 {
 	//Exit
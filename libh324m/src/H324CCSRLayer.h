@@ -4,6 +4,10 @@
 #include "H223AL.h"
 #include "H324pdu.h"
 #include "H223MuxSDU.h"
+#include "H223MuxSDUPool.h"
+#include "FileLogger.h"
+#include "Profiler.h"
+#include "Timer.h"
 
 #include <list>
 
@@ -12,11 +16,14 @@ class H324CCSRLayer :
 	public H223ALSender
 {
 public:
-	H324CCSRLayer();
+	//Without timer wheel the commands are never retransmitted
+	H324CCSRLayer(H223MuxSDUPool *pool,Timer *timer = NULL,TraceBuffer *trace = NULL,Profiler *profiler = NULL);
 	virtual ~H324CCSRLayer();
 
 	//H223ALReceiver interface
 	virtual void Send(BYTE b);
+	virtual void Send(const BYTE *buffer,int len);
+	virtual void SendReversed(const BYTE *buffer,int len);
 	virtual void SendClosingFlag();
 
 	//H223ALSender interface
@@ -27,26 +34,73 @@ public:
 	void SendPDU(H324ControlPDU &pdu);
 	void SendNSRP(BYTE sn);
 
+	//Retransmission timeout in ms, max retransmissions and max outstanding commands
+	void SetRetransmission(DWORD t401,int n400,int window);
+
 	//Events
 	virtual int OnControlPDU(H324ControlPDU &pdu);
 
+	//Counters
+	struct Stats
+	{
+		DWORD	received;
+		DWORD	crcErrors;
+		DWORD	duplicates;
+		DWORD	sent;
+		DWORD	commands;
+		DWORD	retransmissions;
+		DWORD	dropped;
+		DWORD	queued;
+	};
+	const Stats& GetStats();
+
+protected:
+	void BuildCMD(const BYTE *pdu,int pduLen);
+
 protected:
-	void BuildCMD();
+	//Session timer wheel, drives T401
+	Timer* timer;
+
+private:
+	//Command sent and waiting for response
+	struct Command
+	{
+		H223MuxSDU*	sdu;
+		BYTE		sn;
+		Timer::Handle	t401;
+		int		expired;
+		int		retries;
+		int		sending;
+	};
+	typedef std::list<Command> Commands;
+
+	static void OnT401(void *data,int id);
+	void ReleaseCommand(Command &cmd);
+	void OnResponse(int sn);
+	void DecodePDUs(const BYTE *buffer,DWORD len);
 
 private:
+	H223MuxSDUPool *pool;
 	std::list<H223MuxSDU*> cmds;
 	std::list<H223MuxSDU*> rpls;
+	Commands outstanding;
 	PPER_Stream strm;
-	H223MuxSDU* cmd;
 	PPER_Stream sdu;
-	PPER_Stream ccsrl;
+	//Reassembly of the segmented pdus
+	BYTE	*ccsrl;
+	DWORD	ccsrlLen;
+	DWORD	ccsrlSize;
+	int	ccsrlDrop;
 	BYTE	lastsn;
 	BYTE	sentsn;
 	BYTE	cmdsn;
-	int	waiting;
 	int	isCmd;
-	WORD	counter;
-	int	isPDU;
+	DWORD	t401;
+	int	n400;
+	int	window;
+	FileLogger *logger;
+	Profiler *profiler;
+	Stats	stats;
 	
 };
 
@@ -39,6 +39,14 @@ void H223AL1Receiver::Send(BYTE b)
 {
 }
 
+void H223AL1Receiver::Send(const BYTE *buffer,int len)
+{
+}
+
+void H223AL1Receiver::SendReversed(const BYTE *buffer,int len)
+{
+}
+
 void H223AL1Receiver::SendClosingFlag()
 {
 }
@@ -59,8 +67,8 @@ H223AL1Sender::~H223AL1Sender()
 	//Clean sdus pending
 	while(frameList.size()>0)
 	{
-		//Delete front
-		delete frameList.front();
+		//Release front
+		frameList.front()->Release();
 		//Remove
 		frameList.pop_front();
 	}
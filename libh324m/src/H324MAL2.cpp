@@ -24,8 +24,12 @@
 #include "FileLogger.h"
 
 /****************** Receiver **************/
-H223AL2Receiver::H223AL2Receiver(int segmentable,H223SDUListener* listener,int useSequenceNumbers)
+H223AL2Receiver::H223AL2Receiver(H223MuxSDUPool *sduPool,int segmentable,H223SDUListener* listener,int useSequenceNumbers,TraceBuffer *trace)
 {
+	//Store sdu pool
+	pool = sduPool;
+	//Get first sdu
+	sdu = pool->Create(256);
 	//Set sn parameter
 	useSN = useSequenceNumbers;
 	//Save listener
@@ -33,11 +37,16 @@ H223AL2Receiver::H223AL2Receiver(int segmentable,H223SDUListener* listener,int u
 	//Set segmentable
 	segmentableChannel = segmentable;
 	//Create logger
-	logger = new FileLogger();
+	logger = new FileLogger(trace);
+	//No counters
+	sdus = 0;
+	crcErrors = 0;
 }
 
 H223AL2Receiver::~H223AL2Receiver()
 {
+	//Release sdu
+	sdu->Release();
 	//Delete logger
 	delete logger;
 }
@@ -45,13 +54,25 @@ H223AL2Receiver::~H223AL2Receiver()
 void H223AL2Receiver::Send(BYTE b)
 {
 	//Enque in sdu
-	sdu.Push(b);
+	sdu->Push(b);
+}
+
+void H223AL2Receiver::Send(const BYTE *buffer,int len)
+{
+	//Enque all in sdu
+	sdu->Push(buffer,len);
+}
+
+void H223AL2Receiver::SendReversed(const BYTE *buffer,int len)
+{
+	//Enque all in sdu with the bits in order
+	sdu->PushReversed(buffer,len);
 }
 
 void H223AL2Receiver::SendClosingFlag()
 {
 	//Check empty
-	if	(sdu.Length() == 0)
+	if	(sdu->Length() == 0)
 		return;
 
 	//Crc
@@ -62,29 +83,45 @@ void H223AL2Receiver::SendClosingFlag()
 	int dataLen;
 
 	//Check minimum size
-	if (sdu.Length()<2+useSN)
+	if (sdu->Length()<2+useSN)
 		goto clean;
 
 	//Get data
-	data = sdu.GetPointer();
-	dataLen = sdu.Length();
+	data = sdu->GetPointer();
+	dataLen = sdu->Length();
 
 	//Set data
 	crc.Add(data,dataLen-1);
 
 	//Dump media
-	logger->DumpMediaInput(data+useSN,dataLen-useSN-1);
+	TRACE(logger,DumpMediaInput(data+useSN,dataLen-useSN-1));
 	
 	//Calc
 	if (data[dataLen-1]!=crc.Calc())
+	{
+		//Count
+		crcErrors++;
 		goto clean;
+	}
+
+	//One more
+	sdus++;
+
+	//Send to listener without copying
+	sduListener->OnSDU(sdu,data+useSN,dataLen-useSN-1);
 
-	//Send to listener
-	sduListener->OnSDU(data+useSN,dataLen-useSN-1);
+	//Release it, the listener has its own reference if it kept it
+	sdu->Release();
+
+	//Get a new one for next
+	sdu = pool->Create(256);
+
+	//Exit
+	return;
 
 //Clean SDU and exit
 clean:
-	sdu.Clean();
+	sdu->Clean();
 }
 
 int H223AL2Receiver::IsSegmentable()
@@ -93,9 +130,11 @@ int H223AL2Receiver::IsSegmentable()
 }
 
 /****************** Sender **************/
-H223AL2Sender::H223AL2Sender(int segmentable,int useSequenceNumbers)
+H223AL2Sender::H223AL2Sender(H223MuxSDUPool *sduPool,int segmentable,int useSequenceNumbers,TraceBuffer *trace)
 	:jitBuf(0,0)
 {
+	//Store sdu pool
+	pool = sduPool;
 	//Set sn parameter
 	useSN = useSequenceNumbers;
 	sn = 0;
@@ -107,15 +146,17 @@ H223AL2Sender::H223AL2Sender(int segmentable,int useSequenceNumbers)
 	minDelay = 0;
 	minPackets = 0;
 	//Create logger
-	logger = new FileLogger();
+	logger = new FileLogger(trace);
+	//No counters
+	sdus = 0;
 }
 
 H223AL2Sender::~H223AL2Sender()
 {
 	//If we have sent anything
 	if(pdu)
-		//Delete sdu
-		delete pdu;
+		//Release sdu
+		pdu->Release();
 	//Reset queue
 	Reset();
 	//Delete logger
@@ -133,17 +174,19 @@ H223MuxSDU* H223AL2Sender::GetNextPDU()
 
 void H223AL2Sender::OnPDUCompleted()
 {
-	//delete frame
-	delete pdu;
+	//Release frame
+	pdu->Release();
+	//Not sending any more
+	pdu = NULL;
 }
 
-int H223AL2Sender::SendPDU(BYTE *buffer,int len)
+int H223AL2Sender::SendPDU(BYTE *buffer,int len,int reference,int start)
 {
 	//Crc
 	CRC8 crc;
 
 	//Build SDU
-	H223MuxSDU *sdu = new H223MuxSDU();
+	H223MuxSDU *sdu = pool->Create(len+useSN+1);
 
 	//If we have sn
 	if (useSN)
@@ -160,24 +203,21 @@ int H223AL2Sender::SendPDU(BYTE *buffer,int len)
 	sdu->Push(crc.Calc());
 
 	//Dump media
-	logger->DumpMediaOutput(buffer,len);
+	TRACE(logger,DumpMediaOutput(buffer,len));
 
 	//Push sdu into jitterBuffer
-	jitBuf.Push( sdu );
+	jitBuf.Push( sdu, reference, start );
+
+	//One more
+	sdus++;
 
 	//exit
 	return true;
 }
 int H223AL2Sender::Reset()
 {
-	//Free jitter
-	jitBuf.SetBuffer(0,0);
-	//Delete the rest of the jitter buffer packets
-	while(jitBuf.GetSize())
-		//Delete first
-		delete jitBuf.GetSDU();
-	//Set jitter to previous values
-	jitBuf.SetBuffer(minPackets,minDelay);
+	//Release the jitter buffer packets
+	jitBuf.Clear();
 	//Exit
 	return true;
 }
@@ -196,6 +236,14 @@ void H223AL2Sender::SetJitBuffer(int packets,int delay)
 	jitBuf.SetBuffer(packets,delay);
 }
 
+void H223AL2Sender::SetQueue(int capacity, jitterBuffer::Overflow overflow)
+{
+	//Set max queued packets
+	jitBuf.SetCapacity(capacity);
+	//And what to drop when full
+	jitBuf.SetOverflow(overflow);
+}
+
 void H223AL2Sender::Tick(DWORD len)
 {
 	//Set jitter tick
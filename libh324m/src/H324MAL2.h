@@ -4,28 +4,38 @@
 #include "H223AL.h"
 #include "H324pdu.h"
 #include "H223MuxSDU.h"
+#include "H223MuxSDUPool.h"
 #include "jitterBuffer.h"
-#include "log.h"
+#include "FileLogger.h"
 
 class H223AL2Receiver :
 	public H223ALReceiver
 {
 public:
 	//Constructor
-	H223AL2Receiver(int segmentable,H223SDUListener* listener,int useSequenceNumbers);
+	H223AL2Receiver(H223MuxSDUPool *pool,int segmentable,H223SDUListener* listener,int useSequenceNumbers,TraceBuffer *trace = NULL);
 	virtual ~H223AL2Receiver();
 
 	//H223ALReceiver interface
 	virtual void Send(BYTE b);
+	virtual void Send(const BYTE *buffer,int len);
+	virtual void SendReversed(const BYTE *buffer,int len);
 	virtual void SendClosingFlag();
 	virtual int IsSegmentable();
 
+	//Counters
+	DWORD GetSDUs()		{ return sdus; }
+	DWORD GetCRCErrors()	{ return crcErrors; }
+
 private:
 	int	useSN;
 	int segmentableChannel;
 	H223SDUListener* sduListener;
-	H223MuxSDU sdu;
-	Logger *logger;	
+	H223MuxSDUPool *pool;
+	H223MuxSDU *sdu;
+	FileLogger *logger;	
+	DWORD sdus;
+	DWORD crcErrors;
 };
 
 
@@ -34,12 +44,14 @@ class H223AL2Sender :
 {
 public:
 	//Constuctor
-	H223AL2Sender(int segmentable,int useSequenceNumbers);
+	H223AL2Sender(H223MuxSDUPool *pool,int segmentable,int useSequenceNumbers,TraceBuffer *trace = NULL);
 	virtual ~H223AL2Sender();
 
 	//Methods
-	int SendPDU(BYTE *buffer,int len);
+	//Start is false for the rest of the sdus of the same frame
+	int SendPDU(BYTE *buffer,int len,int reference = true,int start = true);
 	void SetJitBuffer(int packets, int delay);
+	void SetQueue(int capacity, jitterBuffer::Overflow overflow);
 	void Tick(DWORD len);
 	int Reset();
 
@@ -47,7 +59,14 @@ public:
 	virtual H223MuxSDU* GetNextPDU();
 	virtual void OnPDUCompleted();
 	virtual int IsSegmentable();
+
+	//Counters
+	DWORD GetSDUs()		{ return sdus; }
+	int   GetQueued()	{ return jitBuf.GetSize(); }
+	int   GetMaxQueued()	{ return jitBuf.GetMaxSize(); }
+	DWORD GetDropped()	{ return jitBuf.GetDropped(); }
 private:
+	H223MuxSDUPool *pool;
 	int useSN;
 	int segmentableChannel;
 	BYTE sn;
@@ -55,7 +74,8 @@ private:
 	jitterBuffer jitBuf;
 	int minPackets;
 	int minDelay;
-	Logger *logger;	
+	FileLogger *logger;	
+	DWORD sdus;
 };
 
 #endif
@@ -39,6 +39,14 @@ void H223AL3Receiver::Send(BYTE b)
 {
 }
 
+void H223AL3Receiver::Send(const BYTE *buffer,int len)
+{
+}
+
+void H223AL3Receiver::SendReversed(const BYTE *buffer,int len)
+{
+}
+
 void H223AL3Receiver::SendClosingFlag()
 {
 }
@@ -60,8 +68,8 @@ H223AL3Sender::~H223AL3Sender()
 	//Clean sdus pending
 	while(frameList.size()>0)
 	{
-		//Delete front
-		delete frameList.front();
+		//Release front
+		frameList.front()->Release();
 		//Remove
 		frameList.pop_front();
 	}
@@ -14,6 +14,8 @@ public:
 	virtual ~H223AL3Receiver();
 	//H223ALReceiver interface
 	virtual void Send(BYTE b);
+	virtual void Send(const BYTE *buffer,int len);
+	virtual void SendReversed(const BYTE *buffer,int len);
 	virtual void SendClosingFlag();
 	virtual int IsSegmentable();
 private:
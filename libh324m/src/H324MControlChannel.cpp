@@ -26,10 +26,16 @@
 
 const unsigned vID[] = {1,37,111,116,111,114,111,108,97,95,49,0}; //Motorola
 
-H324MControlChannel::H324MControlChannel(H245ChannelsFactory* channels) 
+H324MControlChannel::H324MControlChannel(H245ChannelsFactory* channels,Timer* timer) : H324CCSRLayer(channels->GetSDUPool(),timer,channels->GetTrace(),channels->GetProfiler())
 {
 	//Save the logical channels factory
 	cf = channels;
+	//Default timeouts for all the procedures
+	for (int i=0;i<e_NumTimers;i++)
+		//10 seconds
+		timeouts[i] = 10000;
+	//Not failed
+	failed = false;
 	//Create the master slave negotiator
 	ms = new H245MasterSlave(*this);
 	//Create the terminal capabilities exchanger
@@ -129,6 +135,56 @@ int H324MControlChannel::Disconnect()
 	return true;
 }
 
+int H324MControlChannel::SetTimeout(Timers which,DWORD ms)
+{
+	//Check timer
+	if (which<0 || which>=e_NumTimers || !ms)
+		return 0;
+	//Set it, it will be used from the next time it's started
+	timeouts[which] = ms;
+	//OK
+	return 1;
+}
+
+int H324MControlChannel::IsFailed()
+{
+	return failed;
+}
+
+Timer* H324MControlChannel::GetTimer()
+{
+	return timer;
+}
+
+DWORD H324MControlChannel::GetTimeout(Timers which)
+{
+	return timeouts[which];
+}
+
+int H324MControlChannel::OnTimeout(ControlProtocolSource source)
+{
+	//Log
+	Logger::Error("H245 procedure %d timed out\n",source);
+
+	//Depending on the procedure
+	switch(source)
+	{
+		case H245Connection::e_MasterSlaveDetermination:
+		case H245Connection::e_CapabilityExchange:
+		case H245Connection::e_MultiplexTable:
+		case H245Connection::e_LogicalChannel:
+			//Without them the call can't go on
+			failed = true;
+			break;
+		default:
+			//Not fatal
+			break;
+	}
+
+	//Exit
+	return 1;
+}
+
 int H324MControlChannel::OnMasterSlaveDetermination(const H245MasterSlave::Event & event)
 {
 	//Depending on the type
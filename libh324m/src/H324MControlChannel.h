@@ -24,13 +24,17 @@ public:
 	};
 
 public:
-	H324MControlChannel(H245ChannelsFactory* channels);
+	H324MControlChannel(H245ChannelsFactory* channels,Timer* timer);
 	virtual ~H324MControlChannel();
 
 	int CallSetup();
 	int MediaSetup();
 	int Disconnect();
 
+	//H.245 procedure timeouts
+	int SetTimeout(Timers which,DWORD ms);
+	int IsFailed();
+
 public:
 	//User input
 	char*	GetUserInput();
@@ -44,6 +48,9 @@ public:
 	virtual int WriteControlPDU(H324ControlPDU & pdu);
 	virtual int OnError(ControlProtocolSource source, const void *);
 	virtual int OnEvent(const H245Connection::Event &event);
+	virtual int OnTimeout(ControlProtocolSource source);
+	virtual Timer* GetTimer();
+	virtual DWORD GetTimeout(Timers which);
 
 private:
 	int OnH245Request(H245_RequestMessage& req);
@@ -67,6 +74,8 @@ private:
 	H245ChannelsFactory* cf;
 	H245MaintenanceLoop* loop;
 	std::list<char *> inputList;
+	DWORD timeouts[e_NumTimers];
+	int failed;
 
 	int state;
 	int master;
@@ -0,0 +1,795 @@
+/* H324M library
+ *
+ * Copyright (C) 2006 Sergio Garcia Murillo
+ *
+ * sergio.garcia@fontventa.com
+ * http://sip.fontventa.com
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sched.h>
+#include "H324MEngine.h"
+#include "log.h"
+
+//Muxed data kept for the application, 2 seconds of a 64kbps bearer
+#define MAX_OUTPUT	16000
+//Bearer data waiting for the worker, the same 2 seconds
+#define MAX_INPUT	16000
+
+H324MEngine::H324MEngine(int num,int affinity)
+{
+	//Get number of cpus
+	int cpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+	//Check it
+	if (cpus<1)
+		cpus = 1;
+
+	//By default one worker per cpu
+	if (num<=0)
+		num = cpus;
+
+	//Store number of workers
+	numWorkers = num;
+
+	//Create them
+	workers = new Worker[numWorkers];
+
+	//Init all
+	for (int i=0;i<numWorkers;i++)
+	{
+		//Get worker
+		Worker *worker = &workers[i];
+		//Set values
+		worker->engine = this;
+		worker->buffer = NULL;
+		worker->size = 0;
+		worker->running = true;
+		//Pin it to a cpu if requested
+		worker->cpu = affinity>=0 ? (affinity+i)%cpus : -1;
+		//Init sync
+		pthread_mutex_init(&worker->mutex,NULL);
+		pthread_cond_init(&worker->cond,NULL);
+		pthread_cond_init(&worker->done,NULL);
+		//Start thread
+		if (pthread_create(&worker->thread,NULL,Run,worker))
+		{
+			//Log
+			Logger::Error("-Could not start engine worker %d\n",i);
+			//Not running, no sessions will be added to it
+			worker->running = false;
+		}
+	}
+}
+
+H324MEngine::~H324MEngine()
+{
+	//Stop all workers
+	for (int i=0;i<numWorkers;i++)
+	{
+		//Get worker
+		Worker *worker = &workers[i];
+
+		//Lock
+		pthread_mutex_lock(&worker->mutex);
+
+		//Check if it was started
+		int started = worker->running;
+
+		//Stop
+		worker->running = false;
+
+		//Wake it up
+		pthread_cond_signal(&worker->cond);
+
+		//Unlock
+		pthread_mutex_unlock(&worker->mutex);
+
+		//Wait for it
+		if (started)
+			pthread_join(worker->thread,NULL);
+
+		//Delete the sessions not removed
+		for (SlotList::iterator it = worker->slots.begin(); it != worker->slots.end(); ++it)
+		{
+			//Get session
+			H324MSession *session = (*it)->session;
+			//Delete slot first, its frames use the session sdus
+			Delete(*it);
+			//And session
+			delete session;
+		}
+
+		//Free buffer
+		free(worker->buffer);
+
+		//Destroy sync
+		pthread_cond_destroy(&worker->done);
+		pthread_cond_destroy(&worker->cond);
+		pthread_mutex_destroy(&worker->mutex);
+	}
+
+	//Delete workers
+	delete[] workers;
+}
+
+H324MEngine::Slot* H324MEngine::AddSession(H324MSession *session)
+{
+	//Find the running worker with less sessions
+	int best = -1;
+	size_t min = (size_t)-1;
+
+	for (int i=0;i<numWorkers;i++)
+	{
+		//Lock
+		pthread_mutex_lock(&workers[i].mutex);
+		//Get number of sessions
+		size_t n = workers[i].slots.size();
+		//Check it's running
+		int running = workers[i].running;
+		//Unlock
+		pthread_mutex_unlock(&workers[i].mutex);
+		//If it's running and less loaded
+		if (running && n<min)
+		{
+			//Store it
+			best = i;
+			min = n;
+		}
+	}
+
+	//If none is running
+	if (best==-1)
+	{
+		//Log
+		Logger::Error("-No engine worker running\n");
+		//Exit
+		return NULL;
+	}
+
+	//Create slot
+	Slot *slot = new Slot();
+
+	//Set values
+	slot->session = session;
+	slot->worker = best;
+	slot->input = NULL;
+	slot->inputLen = 0;
+	slot->inputSize = 0;
+	slot->output = NULL;
+	slot->outputLen = 0;
+	slot->outputSize = 0;
+	slot->dropped = 0;
+	slot->inputDropped = 0;
+	slot->state = session->GetState();
+	slot->queued = false;
+	slot->busy = false;
+
+	//Get worker
+	Worker *worker = &workers[best];
+
+	//Lock
+	pthread_mutex_lock(&worker->mutex);
+
+	//Append, from now on the session belongs to the worker
+	worker->slots.push_back(slot);
+
+	//Unlock
+	pthread_mutex_unlock(&worker->mutex);
+
+	//Return slot
+	return slot;
+}
+
+H324MSession* H324MEngine::RemoveSession(Slot *slot)
+{
+	//Get worker
+	Worker *worker = &workers[slot->worker];
+
+	//Lock
+	pthread_mutex_lock(&worker->mutex);
+
+	//If it's waiting to be processed
+	if (slot->queued)
+		//Remove from ready list
+		worker->ready.remove(slot);
+
+	//Wait until the worker is done with it
+	while (slot->busy)
+		pthread_cond_wait(&worker->done,&worker->mutex);
+
+	//Remove from worker
+	worker->slots.remove(slot);
+
+	//Unlock
+	pthread_mutex_unlock(&worker->mutex);
+
+	//Get session, now it's owned by the caller again
+	H324MSession *session = slot->session;
+
+	//Delete slot and pending data
+	Delete(slot);
+
+	//Return session
+	return session;
+}
+
+void H324MEngine::Delete(Slot *slot)
+{
+	FrameList::iterator it;
+
+	//Delete pending frames
+	for (it = slot->send.begin(); it != slot->send.end(); ++it)
+		delete *it;
+	for (it = slot->received.begin(); it != slot->received.end(); ++it)
+		delete *it;
+
+	//Free buffers
+	free(slot->input);
+	free(slot->output);
+
+	//Delete slot
+	delete slot;
+}
+
+int H324MEngine::Append(BYTE **buffer,DWORD *length,DWORD *size,const BYTE *data,DWORD len)
+{
+	//If it doesn't fit
+	if (*length+len>*size)
+	{
+		//Grow it
+		BYTE *grown = (BYTE*)realloc(*buffer,(*length+len)*2);
+		//Check
+		if (!grown)
+			//Keep the old one
+			return 0;
+		//Set new one
+		*buffer = grown;
+		*size = (*length+len)*2;
+	}
+
+	//Copy
+	memcpy(*buffer+*length,data,len);
+
+	//Increase length
+	*length += len;
+
+	//Appended
+	return 1;
+}
+
+void H324MEngine::Queue(Slot *slot)
+{
+	//Worker mutex must be locked
+
+	//If already queued
+	if (slot->queued)
+		//Will be processed with the rest
+		return;
+
+	//Get worker
+	Worker *worker = &workers[slot->worker];
+
+	//Append to ready list
+	worker->ready.push_back(slot);
+
+	//Queued
+	slot->queued = true;
+
+	//Wake up worker
+	pthread_cond_signal(&worker->cond);
+}
+
+int H324MEngine::Read(Slot *slot,const BYTE *buffer,int length)
+{
+	//Check
+	if (length<=0)
+		return 0;
+
+	//Get worker
+	Worker *worker = &workers[slot->worker];
+
+	//Lock
+	pthread_mutex_lock(&worker->mutex);
+
+	//If it's more than the max by itself
+	if ((DWORD)length>MAX_INPUT)
+	{
+		//Drop the oldest part of it and all the pending input
+		slot->inputDropped += slot->inputLen+length-MAX_INPUT;
+		slot->inputLen = 0;
+		buffer += length-MAX_INPUT;
+		length = MAX_INPUT;
+	//If it doesn't fit with the pending input
+	} else if (slot->inputLen+length>MAX_INPUT) {
+		//Drop the oldest pending data
+		DWORD drop = slot->inputLen+length-MAX_INPUT;
+		memmove(slot->input,slot->input+drop,slot->inputLen-drop);
+		slot->inputLen -= drop;
+		slot->inputDropped += drop;
+	}
+
+	//Append to input
+	if (!Append(&slot->input,&slot->inputLen,&slot->inputSize,buffer,length))
+	{
+		//Unlock
+		pthread_mutex_unlock(&worker->mutex);
+		//Nothing queued
+		return 0;
+	}
+
+	//Process it
+	Queue(slot);
+
+	//Unlock
+	pthread_mutex_unlock(&worker->mutex);
+
+	//Queued all
+	return length;
+}
+
+int H324MEngine::Write(Slot *slot,BYTE *buffer,int length)
+{
+	//Check
+	if (length<=0)
+		return 0;
+
+	//Get worker
+	Worker *worker = &workers[slot->worker];
+
+	//Lock
+	pthread_mutex_lock(&worker->mutex);
+
+	//Get what we have
+	DWORD len = slot->outputLen;
+
+	//Don't overflow
+	if (len>(DWORD)length)
+		len = length;
+
+	//Copy
+	memcpy(buffer,slot->output,len);
+
+	//Remove it from the output
+	memmove(slot->output,slot->output+len,slot->outputLen-len);
+	slot->outputLen -= len;
+
+	//Unlock
+	pthread_mutex_unlock(&worker->mutex);
+
+	//Return copied
+	return len;
+}
+
+int H324MEngine::GetFrames(Slot *slot,Frame **frames,int max)
+{
+	int num = 0;
+
+	//Get worker
+	Worker *worker = &workers[slot->worker];
+
+	//Lock
+	pthread_mutex_lock(&worker->mutex);
+
+	//Get received frames
+	while (num<max && !slot->received.empty())
+	{
+		//Get first
+		frames[num++] = slot->received.front();
+		//Remove
+		slot->received.pop_front();
+	}
+
+	//Unlock
+	pthread_mutex_unlock(&worker->mutex);
+
+	//Return number of frames
+	return num;
+}
+
+int H324MEngine::SendFrames(Slot *slot,Frame **frames,int num)
+{
+	FrameList send;
+	int i;
+
+	//Take them before locking
+	for (i=0;i<num;i++)
+	{
+		//Get frame
+		Frame *frame = frames[i];
+
+		//The received ones belong to the worker of their session
+		if (frame->IsSDUView())
+		{
+			//Log
+			Logger::Error("-Received frames can't be sent through the engine, copy them\n");
+			//Stop here
+			break;
+		}
+
+		//If the data is borrowed from the application
+		if (frame->IsBorrowed())
+		{
+			//Copy it
+			Frame *copy = new Frame(frame->type,frame->codec,frame->data,frame->dataLength);
+			//And give the data back now
+			delete frame;
+			//Send the copy
+			frame = copy;
+		}
+
+		//Append it
+		send.push_back(frame);
+	}
+
+	//Get worker
+	Worker *worker = &workers[slot->worker];
+
+	//Lock
+	pthread_mutex_lock(&worker->mutex);
+
+	//Queue them, the worker will delete them after sending
+	slot->send.splice(slot->send.end(),send);
+
+	//Process them
+	if (i)
+		Queue(slot);
+
+	//Unlock
+	pthread_mutex_unlock(&worker->mutex);
+
+	//Return the ones taken
+	return i;
+}
+
+int H324MEngine::ReleaseFrames(Slot *slot,Frame **frames,int num)
+{
+	//Wait for the worker, the frames give their sdus back to the session pool
+	Lock(slot);
+
+	//Delete them
+	for (int i=0;i<num;i++)
+		delete frames[i];
+
+	//Unlock
+	Unlock(slot);
+
+	//Released all
+	return num;
+}
+
+int H324MEngine::GetState(Slot *slot)
+{
+	//Get worker
+	Worker *worker = &workers[slot->worker];
+
+	//Lock
+	pthread_mutex_lock(&worker->mutex);
+
+	//Get last known state
+	int state = slot->state;
+
+	//Unlock
+	pthread_mutex_unlock(&worker->mutex);
+
+	//Return it
+	return state;
+}
+
+H324MSession* H324MEngine::Lock(Slot *slot)
+{
+	//Get worker
+	Worker *worker = &workers[slot->worker];
+
+	//Lock
+	pthread_mutex_lock(&worker->mutex);
+
+	//Wait until the worker is done with it, it will not start again while we have the lock
+	while (slot->busy)
+		pthread_cond_wait(&worker->done,&worker->mutex);
+
+	//Return session
+	return slot->session;
+}
+
+void H324MEngine::Unlock(Slot *slot)
+{
+	//The call could have changed it
+	slot->state = slot->session->GetState();
+
+	//Unlock
+	pthread_mutex_unlock(&workers[slot->worker].mutex);
+}
+
+int H324MEngine::End(Slot *slot)
+{
+	//Lock session
+	H324MSession *session = Lock(slot);
+
+	//End it
+	int ret = session->End();
+
+	//Unlock
+	Unlock(slot);
+
+	return ret;
+}
+
+char* H324MEngine::GetUserInput(Slot *slot)
+{
+	//Lock session
+	H324MSession *session = Lock(slot);
+
+	//Get input
+	char *input = session->GetUserInput();
+
+	//Unlock
+	Unlock(slot);
+
+	return input;
+}
+
+int H324MEngine::SendUserInput(Slot *slot,const char *input)
+{
+	//Lock session
+	H324MSession *session = Lock(slot);
+
+	//Send it
+	int ret = session->SendUserInput(input);
+
+	//Unlock
+	Unlock(slot);
+
+	return ret;
+}
+
+int H324MEngine::SendVideoFastUpdatePicture(Slot *slot)
+{
+	//Lock session
+	H324MSession *session = Lock(slot);
+
+	//Send it
+	int ret = session->SendVideoFastUpdatePicture();
+
+	//Unlock
+	Unlock(slot);
+
+	return ret;
+}
+
+int H324MEngine::SetTimeout(Slot *slot,int timer,int ms)
+{
+	//Lock session
+	H324MSession *session = Lock(slot);
+
+	//Set it
+	int ret = session->SetTimeout(timer,ms);
+
+	//Unlock
+	Unlock(slot);
+
+	return ret;
+}
+
+int H324MEngine::Tick(Slot *slot,DWORD ms)
+{
+	//Lock session
+	H324MSession *session = Lock(slot);
+
+	//Advance timers
+	int ret = session->Tick(ms);
+
+	//Unlock
+	Unlock(slot);
+
+	return ret;
+}
+
+int H324MEngine::SetTrace(Slot *slot,int enabled)
+{
+	//Lock session
+	H324MSession *session = Lock(slot);
+
+	//Set it
+	int ret = session->SetTrace(enabled);
+
+	//Unlock
+	Unlock(slot);
+
+	return ret;
+}
+
+int H324MEngine::GetStats(Slot *slot,H324MStats *stats)
+{
+	//Lock session
+	H324MSession *session = Lock(slot);
+
+	//Get session counters
+	int ret = session->GetStats(stats);
+
+	//And ours
+	stats->inputDropped = slot->inputDropped;
+	stats->outputDropped = slot->dropped;
+
+	//Unlock
+	Unlock(slot);
+
+	return ret;
+}
+
+void H324MEngine::Process(Worker *worker,Slot *slot)
+{
+	//Worker mutex is locked on entry and on exit
+	FrameList send;
+	FrameList received;
+	FrameList::iterator it;
+	Frame* frames[32];
+	DWORD len;
+	int num;
+
+	//We are using it
+	slot->busy = true;
+
+	//Get the input
+	len = slot->inputLen;
+
+	//Make room for it
+	if (len>worker->size)
+	{
+		//Grow buffer
+		BYTE *grown = (BYTE*)realloc(worker->buffer,len*2);
+		//If we have it
+		if (grown)
+		{
+			//Set new one
+			worker->buffer = grown;
+			worker->size = len*2;
+		} else {
+			//Log
+			Logger::Error("-Dropping %d bytes of engine input, out of memory\n",len);
+			//Drop the input, the muxer will not write anything for it either
+			len = 0;
+		}
+	}
+
+	//Copy it
+	memcpy(worker->buffer,slot->input,len);
+
+	//Consumed
+	slot->inputLen = 0;
+
+	//Take the frames
+	send.splice(send.end(),slot->send);
+
+	//Unlock while processing
+	pthread_mutex_unlock(&worker->mutex);
+
+	//Get session
+	H324MSession *session = slot->session;
+
+	//Send the frames
+	for (it = send.begin(); it != send.end(); ++it)
+	{
+		//Send
+		session->SendFrame(*it);
+		//Delete it
+		delete *it;
+	}
+
+	//If we have data
+	if (len)
+	{
+		//Demux it
+		session->Read(worker->buffer,len);
+		//Mux the same amount in the same buffer
+		session->Write(worker->buffer,len);
+	}
+
+	//Get received frames
+	while ((num=session->GetFrames(frames,32))>0)
+		//Append them
+		received.insert(received.end(),frames,frames+num);
+
+	//Get state
+	int state = session->GetState();
+
+	//Lock again
+	pthread_mutex_lock(&worker->mutex);
+
+	//Keep only up to the max the application has not written yet
+	DWORD keep = slot->outputLen<MAX_OUTPUT ? MAX_OUTPUT-slot->outputLen : 0;
+	if (keep>len)
+		keep = len;
+
+	//Append the muxed data
+	if (!Append(&slot->output,&slot->outputLen,&slot->outputSize,worker->buffer,keep))
+	{
+		//Log
+		Logger::Error("-Dropping %d bytes of engine output, out of memory\n",keep);
+		//Nothing kept
+		keep = 0;
+	}
+
+	//Count the rest
+	slot->dropped += len-keep;
+
+	//Append the frames
+	slot->received.splice(slot->received.end(),received);
+
+	//Set state
+	slot->state = state;
+
+	//Not using it any more
+	slot->busy = false;
+
+	//Wake up anyone waiting to remove it
+	pthread_cond_broadcast(&worker->done);
+}
+
+void* H324MEngine::Run(void *param)
+{
+	//Get worker
+	Worker *worker = (Worker*)param;
+
+	//If it has to be pinned
+	if (worker->cpu>=0)
+	{
+		cpu_set_t set;
+		//Only its cpu
+		CPU_ZERO(&set);
+		CPU_SET(worker->cpu,&set);
+		//Set affinity
+		if (pthread_setaffinity_np(pthread_self(),sizeof(set),&set))
+			//Log
+			Logger::Error("-Could not set engine worker affinity to cpu %d\n",worker->cpu);
+	}
+
+	//Lock
+	pthread_mutex_lock(&worker->mutex);
+
+	//While running
+	while (worker->running)
+	{
+		//If there is nothing to do
+		if (worker->ready.empty())
+		{
+			//Wait
+			pthread_cond_wait(&worker->cond,&worker->mutex);
+			//Check again
+			continue;
+		}
+
+		//Get first session ready
+		Slot *slot = worker->ready.front();
+
+		//Remove from list
+		worker->ready.pop_front();
+
+		//Not queued any more, new data will queue it again
+		slot->queued = false;
+
+		//Process it
+		worker->engine->Process(worker,slot);
+	}
+
+	//Unlock
+	pthread_mutex_unlock(&worker->mutex);
+
+	//Exit
+	return NULL;
+}
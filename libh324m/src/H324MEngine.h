@@ -0,0 +1,120 @@
+#ifndef _H324MENGINE_H_
+#define _H324MENGINE_H_
+
+#include <pthread.h>
+#include <list>
+#include "H324MSession.h"
+
+/**********************************
+* H324MEngine
+*	Runs many sessions on a fixed pool of worker threads. Each session
+*	is assigned to one worker when added and is only touched by it from
+*	then on, so the session, its sdu pool and its trace buffer keep the
+*	single thread rule and stay in the cache of the same core.
+*
+*	The application calls never block on the session processing: Read
+*	and SendFrames queue data for the worker and wake it up, Write and
+*	GetFrames take whatever the worker has already produced. For each
+*	byte read the worker muxes one byte to be written, so the bearer
+*	keeps its rate with one read of latency.
+*
+*	The rest of the session calls lock the worker and wait for it to end
+*	its current pass on the session, so they are done one at a time.
+*
+*	Received frames keep references to the session sdus, so they must
+*	be given back with ReleaseFrames instead of destroyed. Frames sent
+*	are owned by the engine and destroyed by the worker, the ones with
+*	borrowed data are copied first so it's given back before returning.
+*	Muxed data not written by the application is kept up to MAX_OUTPUT
+*	bytes, the rest is dropped and counted. Read data not yet taken by
+*	the worker is kept up to MAX_INPUT bytes, when it overflows the
+*	oldest is dropped and counted.
+***********************************/
+class H324MEngine
+{
+public:
+	struct Slot;
+
+	H324MEngine(int workers,int affinity);
+	~H324MEngine();
+
+	//Session management, the session must be initialized before adding it
+	//Returns NULL if no worker could be started
+	Slot* AddSession(H324MSession *session);
+	H324MSession* RemoveSession(Slot *slot);
+
+	//Non blocking session io
+	int Read(Slot *slot,const BYTE *buffer,int length);
+	int Write(Slot *slot,BYTE *buffer,int length);
+	int GetFrames(Slot *slot,Frame **frames,int max);
+	int SendFrames(Slot *slot,Frame **frames,int num);
+	int ReleaseFrames(Slot *slot,Frame **frames,int num);
+	int GetState(Slot *slot);
+
+	//Session calls, they wait for the worker
+	int End(Slot *slot);
+	char* GetUserInput(Slot *slot);
+	int SendUserInput(Slot *slot,const char *input);
+	int SendVideoFastUpdatePicture(Slot *slot);
+	int SetTimeout(Slot *slot,int timer,int ms);
+	int Tick(Slot *slot,DWORD ms);
+	int SetTrace(Slot *slot,int enabled);
+	int GetStats(Slot *slot,H324MStats *stats);
+
+	int GetNumWorkers()	{ return numWorkers; }
+
+public:
+	typedef std::list<Frame*> FrameList;
+
+	struct Slot
+	{
+		H324MSession*	session;
+		int		worker;
+		//Protected by the worker mutex
+		BYTE*		input;
+		DWORD		inputLen;
+		DWORD		inputSize;
+		BYTE*		output;
+		DWORD		outputLen;
+		DWORD		outputSize;
+		FrameList	send;
+		FrameList	received;
+		DWORD		dropped;
+		DWORD		inputDropped;
+		int		state;
+		int		queued;
+		int		busy;
+	};
+
+private:
+	typedef std::list<Slot*> SlotList;
+
+	struct Worker
+	{
+		H324MEngine*	engine;
+		int		cpu;
+		pthread_t	thread;
+		pthread_mutex_t	mutex;
+		pthread_cond_t	cond;
+		pthread_cond_t	done;
+		SlotList	ready;
+		SlotList	slots;
+		BYTE*		buffer;
+		DWORD		size;
+		int		running;
+	};
+
+	void Queue(Slot *slot);
+	void Process(Worker *worker,Slot *slot);
+	void Delete(Slot *slot);
+	H324MSession* Lock(Slot *slot);
+	void Unlock(Slot *slot);
+	static int  Append(BYTE **buffer,DWORD *length,DWORD *size,const BYTE *data,DWORD len);
+	static void* Run(void *worker);
+
+private:
+	Worker*	workers;
+	int	numWorkers;
+};
+
+#endif
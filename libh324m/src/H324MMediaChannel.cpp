@@ -23,14 +23,20 @@
 #include "log.h"
 
 
-H324MMediaChannel::H324MMediaChannel(int jitter, int delay)
+H324MMediaChannel::H324MMediaChannel(H223MuxSDUPool *sduPool,TraceBuffer *sessionTrace,int jitter, int delay)
 {
+	pool = sduPool;
+	trace = sessionTrace;
+	first = NULL;
+	last = NULL;
 	state = e_AwaitingEstablishment;
 	localChannel = 0;
 	remoteChannel = 0;
 	isBidirectional = 0;
 	sender = NULL;
+	al2 = NULL;
 	receiver = NULL;
+	al2Receiver = NULL;
 	jitterPackets = jitter;
 	jitterActive = false;
 	minDelay = delay;
@@ -40,6 +46,10 @@ H324MMediaChannel::H324MMediaChannel(int jitter, int delay)
 
 H324MMediaChannel::~H324MMediaChannel()
 {
+	//Delete pending frames
+	while (first)
+		//Delete first
+		delete GetFrame();
 }
 
 int H324MMediaChannel::Init()
@@ -53,6 +63,11 @@ int H324MMediaChannel::End()
 		delete sender;
 	if (receiver)
 		delete receiver;
+	//No senders
+	sender = NULL;
+	al2 = NULL;
+	receiver = NULL;
+	al2Receiver = NULL;
 
 	return 1;
 }
@@ -79,13 +94,17 @@ int H324MMediaChannel::SetSenderLayer(AdaptationLayer layer, int segmentable)
 			break;
 		case e_al2WithoutSequenceNumbers:
 			// AL 2
-			sender = new H223AL2Sender(segmentable,false);
+			sender = al2 = new H223AL2Sender(pool,segmentable,false,trace);
 			//Set jitterBuffer
-			((H223AL2Sender *)sender)->SetJitBuffer(jitterPackets, minDelay);
+			al2->SetJitBuffer(jitterPackets, minDelay);
+			//Set queue
+			SetQueue(al2);
 			break;
 		case e_al2WithSequenceNumbers:
 			// AL 2
-			sender = new H223AL2Sender(segmentable,true);
+			sender = al2 = new H223AL2Sender(pool,segmentable,true,trace);
+			//Set queue
+			SetQueue(al2);
 			break;
 		case e_al3:
 			// AL3
@@ -99,6 +118,17 @@ int H324MMediaChannel::SetSenderLayer(AdaptationLayer layer, int segmentable)
 	return 1;
 }
 
+void H324MMediaChannel::SetQueue(H223AL2Sender *al2)
+{
+	//Depending on the type
+	if (type == e_Audio)
+		//Up to 64 frames, keep the newest ones
+		al2->SetQueue(64,jitterBuffer::e_DropOldest);
+	else
+		//Up to 512 fragments, keep intra frames
+		al2->SetQueue(512,jitterBuffer::e_DropNonReference);
+}
+
 int H324MMediaChannel::SetReceiverLayer(AdaptationLayer layer, int segmentable)
 {
 	//Dependind on the adaptation layer
@@ -111,11 +141,11 @@ int H324MMediaChannel::SetReceiverLayer(AdaptationLayer layer, int segmentable)
 			break;
 		case e_al2WithoutSequenceNumbers:
 			// AL 2
-			receiver = new H223AL2Receiver(segmentable,this,false);
+			receiver = al2Receiver = new H223AL2Receiver(pool,segmentable,this,false,trace);
 			break;
 		case e_al2WithSequenceNumbers:
 			// AL 2
-			receiver = new H223AL2Receiver(segmentable,this,true);
+			receiver = al2Receiver = new H223AL2Receiver(pool,segmentable,this,true,trace);
 			break;
 		case e_al3:
 			// AL3
@@ -128,21 +158,44 @@ int H324MMediaChannel::SetReceiverLayer(AdaptationLayer layer, int segmentable)
 	//Exit
 	return 1;
 }
+void H324MMediaChannel::GetStats(H324MChannelStats *stats)
+{
+	//Channel numbers
+	stats->localChannel = localChannel;
+	stats->remoteChannel = remoteChannel;
+
+	//Only the AL2 has counters
+	if (al2Receiver)
+	{
+		//Received
+		stats->sdusIn = al2Receiver->GetSDUs();
+		stats->crcErrors = al2Receiver->GetCRCErrors();
+	}
+	if (al2)
+	{
+		//Sent and queued
+		stats->sdusOut = al2->GetSDUs();
+		stats->queued = al2->GetQueued();
+		stats->maxQueued = al2->GetMaxQueued();
+		stats->dropped = al2->GetDropped();
+	}
+}
+
 void H324MMediaChannel::Tick(DWORD value)
 {
 	//Increase counter
 	ticks += value;
-	//If got sender
-	if(sender)
-		((H223AL2Sender*)sender)->Tick( value);
+	//Only the AL2 sender has a queue to tick
+	if(al2)
+		al2->Tick( value);
 }
 
 void H324MMediaChannel::Reset()
 {
-	//If got sender
-	if(sender)
+	//Only the AL2 sender has a queue to reset
+	if(al2)
 		//Reset send queue
-		((H223AL2Sender*)sender)->Reset();
+		al2->Reset();
 }
 
 void H324MMediaChannel::OnSDU(BYTE* data,DWORD length)
@@ -153,34 +206,107 @@ void H324MMediaChannel::OnSDU(BYTE* data,DWORD length)
 		codec = e_AMR;
 	else
 		codec = e_H263;
-	//Enque new frame
-	frameList.push_back(new Frame(type,codec,data,length));
+	//Enque a copy
+	Enqueue(new Frame(type,codec,data,length));
+}
+
+void H324MMediaChannel::OnSDU(H223MuxSDU *sdu,BYTE* data,DWORD length)
+{
+	MediaCodec codec;
+	//Depending on the type
+	if (type == e_Audio)
+		codec = e_AMR;
+	else
+		codec = e_H263;
+	//Enque a view of the sdu
+	Enqueue(new Frame(type,codec,sdu,data,length));
+}
+
+void H324MMediaChannel::Enqueue(Frame *frame)
+{
+	//Append to the end of the queue
+	if (last)
+		last->next = frame;
+	else
+		first = frame;
+	//It's the last one
+	last = frame;
 }
 
 Frame* H324MMediaChannel::GetFrame()
 {
 	//Check size
-	if (frameList.size()==0)
+	if (!first)
 	{
 		//No packet
 		return NULL;
 	}
 	//Check if sending sending or have enougth packets
 	//Get frame
-	Frame *frame = frameList.front();
+	Frame *frame = first;
 	//Remove
-	frameList.pop_front();
+	first = frame->next;
+	//If it was the last one
+	if (!first)
+		//Empty
+		last = NULL;
+	//Unlink it
+	frame->next = NULL;
 	//Return frame
 	return frame;
 }
 
+int H324MMediaChannel::GetFrames(Frame **frames,int max)
+{
+	int num = 0;
+
+	//Unlink frames from the head of the queue
+	while (first && num<max)
+	{
+		//Get frame
+		frames[num++] = first;
+		//Remove
+		first = first->next;
+		//Unlink it
+		frames[num-1]->next = NULL;
+	}
+
+	//If it's empty now
+	if (!first)
+		//No last one
+		last = NULL;
+
+	//Return number of frames
+	return num;
+}
+
+int H324MMediaChannel::IsIntra(Frame *frame)
+{
+	//Only video frames can be dropped
+	if (frame->codec!=e_H263)
+		return true;
+
+	//Check picture start code
+	if (frame->dataLength<5 || frame->data[0]!=0 || frame->data[1]!=0 || (frame->data[2]&0xFC)!=0x80)
+		//Not a picture start, don't know
+		return true;
+
+	//If the source format is extended the picture type is in the PLUSPTYPE
+	if (((frame->data[4]>>2) & 0x07)==0x07)
+		//Don't know
+		return true;
+
+	//Picture coding type of the PTYPE, 0 is intra
+	return !(frame->data[4] & 0x02);
+}
+
 int H324MMediaChannel::SendFrame(Frame *frame)
 {
 	//Debug
 	Logger::Debug("-Sending Frame [%d,%d]\n",frame->type,frame->dataLength);
 
-	//Check sender
-	if (!sender)
+	//Check sender, AL1 and AL3 senders can't send media yet
+	if (!al2)
 		//Exit
 		return 0;
 
@@ -188,6 +314,9 @@ int H324MMediaChannel::SendFrame(Frame *frame)
 	DWORD len = 0;
     	DWORD pos = 0;
 
+	//Intra frames are not dropped before the others
+	int reference = IsIntra(frame);
+
 	//Sen up to max size
 	while (pos<frame->dataLength)
 	{
@@ -201,8 +330,8 @@ int H324MMediaChannel::SendFrame(Frame *frame)
 
 		//Debug
 		Logger::Debug("-Sending PDU [%d,%d,%d]\n",pos,len,frame->dataLength);
-		//Send
-		((H223AL2Sender*)sender)->SendPDU(frame->data+pos,len);
+		//Send, all of them are dropped together
+		al2->SendPDU(frame->data+pos,len,reference,pos==0);
 		//Increase len
 		pos += len;
 	}
@@ -211,13 +340,13 @@ int H324MMediaChannel::SendFrame(Frame *frame)
 	return pos;
 }
 
-H324MAudioChannel::H324MAudioChannel(int jitter,int delay) : H324MMediaChannel(jitter,delay)
+H324MAudioChannel::H324MAudioChannel(H223MuxSDUPool *pool,TraceBuffer *trace,int jitter,int delay) : H324MMediaChannel(pool,trace,jitter,delay)
 {
 	//Set audio type
 	type = e_Audio;
 }
 
-H324MVideoChannel::H324MVideoChannel() : H324MMediaChannel(0,0)
+H324MVideoChannel::H324MVideoChannel(H223MuxSDUPool *pool,TraceBuffer *trace) : H324MMediaChannel(pool,trace,0,0)
 {
 	//Set video type
 	type = e_Video;
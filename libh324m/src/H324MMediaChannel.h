@@ -4,7 +4,9 @@
 #include "H324MAL1.h"
 #include "H324MAL2.h"
 #include "H324MAL3.h"
+#include "H223MuxSDUPool.h"
 #include "Media.h"
+#include "../include/h324m.h"
 
 class H324MMediaChannel :
 	public H223SDUListener
@@ -21,7 +23,7 @@ public:
     };
 
 public:
-	H324MMediaChannel(int jitter,int delay);
+	H324MMediaChannel(H223MuxSDUPool *pool,TraceBuffer *trace,int jitter,int delay);
 	virtual ~H324MMediaChannel();
 
 	int Init();
@@ -34,13 +36,20 @@ public:
 
 	//SDUListener interface
 	virtual void OnSDU(BYTE* data,DWORD length);
+	virtual void OnSDU(H223MuxSDU *sdu,BYTE* data,DWORD length);
 
 	int SetSenderLayer(AdaptationLayer layer, int segmentable);
 	int SetReceiverLayer(AdaptationLayer layer, int segmentable);
+	void SetQueue(H223AL2Sender *al2);
 
 	//Methods
 	Frame* GetFrame();
+	int GetFrames(Frame **frames,int max);
 	int SendFrame(Frame *frame);
+	static int IsIntra(Frame *frame);
+
+	//Counters of the adaptation layers
+	void GetStats(H324MChannelStats *stats);
 
 	int localChannel;
 	int remoteChannel;
@@ -51,9 +60,17 @@ public:
 	State state;
 
 private:
+	void Enqueue(Frame *frame);
+
+private:
+	H223MuxSDUPool *pool;
+	TraceBuffer *trace;
 	H223ALReceiver *receiver;
 	H223ALSender *sender;
-	list<Frame*> frameList;
+	H223AL2Sender *al2;
+	H223AL2Receiver *al2Receiver;
+	Frame* first;
+	Frame* last;
 	int	jitterPackets;
 	int jitterActive;
 	DWORD ticks;
@@ -65,14 +82,14 @@ class H324MAudioChannel :
 	public H324MMediaChannel
 {
 public:
-	H324MAudioChannel(int jitter,int delay);
+	H324MAudioChannel(H223MuxSDUPool *pool,TraceBuffer *trace,int jitter,int delay);
 };
 
 class H324MVideoChannel :
 	public H324MMediaChannel
 {
 public:
-	H324MVideoChannel();
+	H324MVideoChannel(H223MuxSDUPool *pool,TraceBuffer *trace);
 };
 
 #endif
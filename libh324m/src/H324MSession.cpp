@@ -19,27 +19,42 @@
  * along with this program; if not, write to the Free Software
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
  */
+#include <stdio.h>
+#include <string.h>
 #include "H324MSession.h"
 #include "FileLogger.h"
 
 H324MSession::H324MSession()
 {
+	//Get the default log level and callback
+	Logger::InitContext(&logContext);
+	//Log with our level and callback
+	Logger::Scope scope(&logContext);
+
 	//Set state
 	state = e_None;
+	//Timers driven by the written bytes until the user ticks them
+	written = 0;
+	ticked = false;
 	//Create the control channel
-	controlChannel = new H324MControlChannel(&channels);
+	controlChannel = new H324MControlChannel(&channels,&timer);
 	//Create audio channel
 	audio = channels.CreateChannel(e_Audio);
 	//Create video channel
 	video = channels.CreateChannel(e_Video);
 	//Init channels
 	channels.Init(controlChannel,controlChannel,this);
+	//Bits are reversed in the bearer by default
+	channels.SetReverseBits(true);
 	//Create logger
-	logger = new FileLogger();
+	logger = new FileLogger(channels.GetTrace());
 }
 
 H324MSession::~H324MSession()
 {
+	//Log with our level and callback
+	Logger::Scope scope(&logContext);
+
 	//End channels
 	channels.End();
 	//Delete control channel
@@ -50,6 +65,9 @@ H324MSession::~H324MSession()
 
 int H324MSession::Init()
 {
+	//Log with our level and callback
+	Logger::Scope scope(&logContext);
+
 	//Set state
 	state = e_Setup;
 	//Call Setup
@@ -58,6 +76,9 @@ int H324MSession::Init()
 
 int H324MSession::End()
 {
+	//Log with our level and callback
+	Logger::Scope scope(&logContext);
+
 	//Set state
 	state = e_Hangup;
 	//Disconnect channels
@@ -66,8 +87,11 @@ int H324MSession::End()
 
 int H324MSession::Read(BYTE *buffer,int length)
 {
+	//Log with our level and callback
+	Logger::Scope scope(&logContext);
+
 	//Dump data
-	logger->DumpInput(buffer,length);
+	TRACE(logger,DumpInput(buffer,length));
 
 	//Demultiplex
 	return channels.Demultiplex(buffer,length);
@@ -77,39 +101,86 @@ int H324MSession::Write(BYTE *buffer,int length)
 {
 	int ret;
 
+	//Log with our level and callback
+	Logger::Scope scope(&logContext);
+
 	//Multiplex
 	ret = channels.Multiplex(buffer,length);
 
+	//If the timers are not ticked by the user
+	if (!ticked)
+	{
+		//At 64kbps each 8 bytes are 1 ms
+		written += length;
+		//Advance the procedure timers
+		timer.Tick(written/8);
+		//Keep the remainder
+		written %= 8;
+	}
+
 	//Dump data
-	logger->DumpOutput(buffer,length);
+	TRACE(logger,DumpOutput(buffer,length));
 
 	return ret;
 }
 Frame* H324MSession::GetFrame()
 {
+	//Log with our level and callback
+	Logger::Scope scope(&logContext);
+
 	//Send Frame
 	return channels.GetFrame();
 }
 
 int H324MSession::SendFrame(Frame *frame)
 {
+	//Log with our level and callback
+	Logger::Scope scope(&logContext);
+
 	//Return Frame
 	return channels.SendFrame(frame);
 }
 
+int H324MSession::GetFrames(Frame **frames,int max)
+{
+	//Log with our level and callback
+	Logger::Scope scope(&logContext);
+
+	//Get as many frames as they fit
+	return channels.GetFrames(frames,max);
+}
+
+int H324MSession::SendFrames(Frame **frames,int num)
+{
+	//Log with our level and callback
+	Logger::Scope scope(&logContext);
+
+	//Send all of them
+	return channels.SendFrames(frames,num);
+}
+
 char* H324MSession::GetUserInput()
 {
+	//Log with our level and callback
+	Logger::Scope scope(&logContext);
+
 	//Get input
 	return controlChannel->GetUserInput();
 }
 int	H324MSession::SendUserInput(const char *input)
 {
+	//Log with our level and callback
+	Logger::Scope scope(&logContext);
+
 	//Send input
 	return controlChannel->SendUserInput(input);
 }
 
 int H324MSession::SendVideoFastUpdatePicture()
 {
+	//Log with our level and callback
+	Logger::Scope scope(&logContext);
+
 	//Get remote video channel
 	int video = channels.GetRemoteChannel(e_Video);
 	//If we have one
@@ -122,6 +193,11 @@ int H324MSession::SendVideoFastUpdatePicture()
 
 H324MSession::CallState H324MSession::GetState()
 {
+	//If a H.245 procedure failed there is no call
+	if (controlChannel->IsFailed())
+		//Hang up
+		state = e_Hangup;
+
 	return state;
 }
 
@@ -146,6 +222,110 @@ int H324MSession::OnChannelReleased(int channel, MediaType type)
 
 int H324MSession::ResetMediaQueue()
 {
+	//Log with our level and callback
+	Logger::Scope scope(&logContext);
+
 	//Call the media channels reset
 	return channels.Reset();
 }
+
+int H324MSession::SetTrace(int enabled)
+{
+	//Enable tracing for this session
+	channels.GetTrace()->SetEnabled(enabled);
+	//OK
+	return 1;
+}
+
+int H324MSession::GetStats(H324MStats *stats)
+{
+	//Clean
+	memset(stats,0,sizeof(H324MStats));
+
+	//Get mux, demux and media channels counters
+	channels.GetStats(stats);
+
+	//Get the srp ones
+	const H324CCSRLayer::Stats &srp = controlChannel->GetStats();
+
+	//Set them
+	stats->srpCommands = srp.commands;
+	stats->srpRetransmissions = srp.retransmissions;
+	stats->srpDuplicates = srp.duplicates;
+
+	//And the control channel ones
+	H324MChannelStats *control = &stats->channels[STATS_CONTROL];
+	control->sdusIn = srp.received;
+	control->sdusOut = srp.sent;
+	control->crcErrors = srp.crcErrors;
+	control->queued = srp.queued;
+	control->dropped = srp.dropped;
+
+	return 1;
+}
+
+Profiler* H324MSession::GetProfiler()
+{
+	//Return the profiler of the session
+	return channels.GetProfiler();
+}
+
+int H324MSession::SetLogger(int level,Logger::Callback callback)
+{
+	//Check level
+	if (level<0)
+		return 0;
+	//Set them
+	logContext.level = level;
+	logContext.callback = callback ? callback : vprintf;
+	//OK
+	return 1;
+}
+
+int H324MSession::SetReverseBits(int reverse)
+{
+	//Mux and demux with the bearer bit order
+	return channels.SetReverseBits(reverse);
+}
+
+int H324MSession::SetControlRetransmission(int t401,int n400,int window)
+{
+	//Check values
+	if (t401<=0 || n400<0)
+		return 0;
+	//Set them in the control channel
+	controlChannel->SetRetransmission(t401,n400,window);
+	//OK
+	return 1;
+}
+
+int H324MSession::SetTimeout(int which,int ms)
+{
+	//Log with our level and callback
+	Logger::Scope scope(&logContext);
+
+	//Check values
+	if (ms<=0)
+		return 0;
+	//Set it in the control channel
+	return controlChannel->SetTimeout((H245Connection::Timers)which,ms);
+}
+
+int H324MSession::Tick(DWORD ms)
+{
+	//Log with our level and callback
+	Logger::Scope scope(&logContext);
+
+	//From now on the time is given by the user
+	ticked = true;
+	//Advance the procedure timers
+	timer.Tick(ms);
+	//OK
+	return 1;
+}
+
+int H324MSession::SetMuxPolicy(int policy)
+{
+	//Set muxer policy
+	return channels.SetMuxPolicy((H223Muxer::Policy)policy);
+}
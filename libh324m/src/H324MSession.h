@@ -3,7 +3,7 @@
 
 #include "H245ChannelsFactory.h"
 #include "H324MControlChannel.h"
-#include "log.h"
+#include "FileLogger.h"
 
 class H324MSession 
 	: public H245ChannelsFactoryListener
@@ -28,7 +28,9 @@ public:
 
 	//Media frame functions
 	Frame*	GetFrame();
+	int		GetFrames(Frame **frames,int max);
 	int		SendFrame(Frame *frame);
+	int		SendFrames(Frame **frames,int num);
 
 	//User input functions
 	char*	GetUserInput();
@@ -39,6 +41,31 @@ public:
 	int		ResetMediaQueue();
 	CallState	GetState();
 
+	//Mux
+	int		SetMuxPolicy(int policy);
+
+	//Bit order of the bearer
+	int		SetReverseBits(int reverse);
+
+	//H.245 SRP timer (ms), retries and window
+	int		SetControlRetransmission(int t401,int n400,int window);
+
+	//H.245 procedure timers
+	int		SetTimeout(int timer,int ms);
+	int		Tick(DWORD ms);
+
+	//Trace
+	int		SetTrace(int enabled);
+
+	//Log level and callback of this session
+	int		SetLogger(int level,Logger::Callback callback);
+
+	//Time spent in each stage, disabled by default
+	Profiler*	GetProfiler();
+
+	//Counters
+	int		GetStats(H324MStats *stats);
+
 	//H245ChannelsFactoryListener
 	virtual int OnChannelStablished(int channel, MediaType type);
 	virtual int OnChannelReleased(int channel, MediaType type);
@@ -51,7 +78,11 @@ private:
 	CallState			state;
 	H245ChannelsFactory channels;
 	H324MControlChannel *controlChannel;
-	Logger *logger;
+	Timer	timer;
+	DWORD	written;
+	int	ticked;
+	FileLogger *logger;
+	Logger::Context	logContext;
 	int	audio;
 	int	video;
 	
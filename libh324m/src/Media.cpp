@@ -22,6 +22,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include "Media.h"
+#include "H223MuxSDU.h"
 
 Frame::Frame(MediaType t,MediaCodec c,BYTE *d,DWORD l)
 {
@@ -29,15 +30,66 @@ Frame::Frame(MediaType t,MediaCodec c,BYTE *d,DWORD l)
 	type = t;
 	codec = c;
 	dataLength = l;
+	next = NULL;
 	//Alloc memory
 	data = (BYTE*)malloc(dataLength);
 	//Copy memory
 	memcpy(data,d,dataLength);
+	//We own it
+	owned = true;
+	sdu = NULL;
+	release = NULL;
+	param = NULL;
+}
+
+Frame::Frame(MediaType t,MediaCodec c,H223MuxSDU *s,BYTE *d,DWORD l)
+{
+	//Set type & codec & length
+	type = t;
+	codec = c;
+	dataLength = l;
+	next = NULL;
+	//Point to the sdu data
+	data = d;
+	//Keep the sdu
+	sdu = s;
+	sdu->AddRef();
+	//Not owned
+	owned = false;
+	release = NULL;
+	param = NULL;
+}
+
+Frame::Frame(MediaType t,MediaCodec c,BYTE *d,DWORD l,FrameRelease r,void *p)
+{
+	//Set type & codec & length
+	type = t;
+	codec = c;
+	dataLength = l;
+	next = NULL;
+	//Point to the data
+	data = d;
+	//Store release callback
+	release = r;
+	param = p;
+	//Not owned
+	owned = false;
+	sdu = NULL;
 }
 
 Frame::~Frame()
 {
-	//Free memory
-	free(data);
+	//If it's our copy
+	if (owned)
+		//Free memory
+		free(data);
+	//If it's from a sdu
+	if (sdu)
+		//Release it
+		sdu->Release();
+	//If it's borrowed
+	if (release)
+		//Give it back
+		release(param,data);
 }
 
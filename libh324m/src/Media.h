@@ -24,15 +24,37 @@ enum AdaptationLayer {
 	e_al3
 };
 
+class H223MuxSDU;
+
+typedef void (*FrameRelease)(void *param,BYTE *data);
+
 class Frame
 {
 public:
+	//Copy of the data
 	Frame(MediaType type,MediaCodec codec,BYTE *data,DWORD length);
+	//View of the data of a received sdu, keeps a reference to it
+	Frame(MediaType type,MediaCodec codec,H223MuxSDU *sdu,BYTE *data,DWORD length);
+	//Borrowed data, release is called on destruction if not null
+	Frame(MediaType type,MediaCodec codec,BYTE *data,DWORD length,FrameRelease release,void *param);
 	~Frame();
 
+	//If it keeps a reference to a received sdu
+	int IsSDUView()		{ return sdu!=NULL; }
+	//If the data is not ours nor of a sdu
+	int IsBorrowed()	{ return !owned && !sdu; }
+
 	MediaType	type;
 	MediaCodec	codec;
 	BYTE*		data;
 	DWORD		dataLength;
+	//Next frame in the channel queue
+	Frame*		next;
+
+private:
+	H223MuxSDU*	sdu;
+	FrameRelease	release;
+	void*		param;
+	int		owned;
 };
 #endif
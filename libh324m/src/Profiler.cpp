@@ -0,0 +1,102 @@
+/* H324M library
+ *
+ * Copyright (C) 2006 Sergio Garcia Murillo
+ *
+ * sergio.garcia@fontventa.com
+ * http://sip.fontventa.com
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+#include <time.h>
+#include "Profiler.h"
+
+static const char* names[] = {"idle","demux","al","control","frames","mux"};
+
+Profiler::Profiler()
+{
+	//Disabled
+	enabled = false;
+	//Outside the library
+	current = e_Idle;
+	last = 0;
+	//Clean counters
+	Reset();
+}
+
+void Profiler::SetEnabled(int e)
+{
+	//Start the idle interval now
+	last = Now();
+	current = e_Idle;
+	//Set
+	enabled = e;
+}
+
+void Profiler::Reset()
+{
+	//Clean all stages
+	for (int i=0;i<e_NumStages;i++)
+	{
+		time[i] = 0;
+		count[i] = 0;
+	}
+}
+
+const char* Profiler::GetName(Stage stage)
+{
+	//Check
+	if (stage<0 || stage>=e_NumStages)
+		return "unknown";
+	//Return name
+	return names[stage];
+}
+
+Profiler::Stage Profiler::Enter(Stage stage)
+{
+	unsigned long long now = Now();
+	Stage prev = current;
+
+	//Charge the interval to the running stage
+	time[current] += now-last;
+	last = now;
+
+	//Switch
+	current = stage;
+	count[stage]++;
+
+	//Return the one to go back to
+	return prev;
+}
+
+void Profiler::Leave(Stage prev)
+{
+	unsigned long long now = Now();
+
+	//Charge the interval to the running stage
+	time[current] += now-last;
+	last = now;
+
+	//Go back
+	current = prev;
+}
+
+unsigned long long Profiler::Now()
+{
+	struct timespec ts;
+	//Get monotonic time, in the vdso
+	clock_gettime(CLOCK_MONOTONIC,&ts);
+	//In ns
+	return (unsigned long long)ts.tv_sec*1000000000ULL + ts.tv_nsec;
+}
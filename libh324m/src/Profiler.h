@@ -0,0 +1,78 @@
+#ifndef _PROFILER_H_
+#define _PROFILER_H_
+
+#include "H324MConfig.h"
+
+/**********************************
+* Profiler
+*	Per session accounting of the time spent in each processing stage.
+*	Stages are nested (the demuxer calls the AL receivers, which decode
+*	the control SDUs), so the time is charged to the innermost one:
+*	entering a stage closes the running interval of the current one and
+*	leaving it goes back. Disabled by default, then a stage switch is
+*	just the check of a flag.
+*
+*	Times are read from the monotonic clock, much cheaper than the
+*	thread cpu one, so they are cpu time while the thread is not
+*	preempted. Run at most one session thread per core when profiling.
+***********************************/
+class Profiler
+{
+public:
+	enum Stage {
+		e_Idle,
+		e_Demux,
+		e_AL,
+		e_Control,
+		e_Frames,
+		e_Mux,
+		e_NumStages
+	};
+
+	//Charges the time to a stage until it goes out of scope
+	class Scope
+	{
+	public:
+		Scope(Profiler *p,Stage stage)
+		{
+			//Only if enabled
+			profiler = (p && p->enabled) ? p : NULL;
+			if (profiler)
+				prev = profiler->Enter(stage);
+		}
+		~Scope()
+		{
+			if (profiler)
+				profiler->Leave(prev);
+		}
+	private:
+		Profiler*	profiler;
+		Stage		prev;
+	};
+
+public:
+	Profiler();
+
+	void SetEnabled(int enabled);
+	int  IsEnabled()	{ return enabled; }
+	void Reset();
+
+	//Nanoseconds spent and times entered
+	unsigned long long GetTime(Stage stage)	{ return time[stage]; }
+	DWORD GetCount(Stage stage)		{ return count[stage]; }
+	static const char* GetName(Stage stage);
+
+private:
+	Stage Enter(Stage stage);
+	void  Leave(Stage prev);
+	static unsigned long long Now();
+
+private:
+	int			enabled;
+	Stage			current;
+	unsigned long long	last;
+	unsigned long long	time[e_NumStages];
+	DWORD			count[e_NumStages];
+};
+
+#endif
@@ -19,113 +19,212 @@
  * along with this program; if not, write to the Free Software
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
  */
+#include <string.h>
 #include "Timer.h"
 
-Timer::Data::Data(Handler h,void* d)
-	: handler(h), data(d),set(0),when(0)
+Timer::Timer(DWORD res)
 {
+	//Empty wheels
+	memset(wheel0,0,sizeof(wheel0));
+	memset(wheel,0,sizeof(wheel));
+	//At least 1ms
+	resolution = res ? res : 1;
+	//Start
+	now = 0;
+	rest = 0;
 }
 
-void Timer::Data::Set(DWORD t)
+Timer::~Timer()
 {
-	//Set flag
-	set = 1;
-	//Update when
-	when = t;
 }
 
-void Timer::Data::Reset()
+void Timer::Add(Data *d)
 {
-	//ReSet flag
-	set = 0;
-	//Update when
-	when = 0;
+	Data **slot;
+
+	//Get ticks to expire
+	DWORD delta = d->when - now;
+
+	//Don't go past the last level
+	if (delta>=MaxTicks)
+	{
+		//Clamp
+		delta = MaxTicks-1;
+		d->when = now + delta;
+	}
+
+	//Get slot depending on how far it is
+	if (delta<Level0Size)
+		slot = &wheel0[d->when & (Level0Size-1)];
+	else if (delta<1<<(Level0Bits+LevelBits))
+		slot = &wheel[0][(d->when>>Level0Bits) & (LevelSize-1)];
+	else if (delta<1<<(Level0Bits+2*LevelBits))
+		slot = &wheel[1][(d->when>>(Level0Bits+LevelBits)) & (LevelSize-1)];
+	else
+		slot = &wheel[2][(d->when>>(Level0Bits+2*LevelBits)) & (LevelSize-1)];
+
+	//Insert at the begining
+	d->next = *slot;
+	if (d->next)
+		d->next->pprev = &d->next;
+	d->pprev = slot;
+	*slot = d;
 }
 
-Timer::Timer()
+void Timer::Remove(Data *d)
 {
-	//Set up initial timer
-	time = 0;
+	//Unlink
+	*d->pprev = d->next;
+	if (d->next)
+		d->next->pprev = d->pprev;
+	//Not set
+	d->next = NULL;
+	d->pprev = NULL;
 }
 
-Timer::~Timer()
+void Timer::Cascade(Data **slot)
 {
+	//Get timers of the slot
+	Data *d = *slot;
+
+	//Empty it
+	*slot = NULL;
+
+	//Put them again in a lower level
+	while (d)
+	{
+		//Get next
+		Data *next = d->next;
+		//Add
+		Add(d);
+		//Next
+		d = next;
+	}
 }
 
-DWORD Timer::Tick(int ms)
+DWORD Timer::Step()
 {
-	//Increase time
-	time += ms;
+	DWORD fired = 0;
 
-	//Check timers
-	if (time>=next)
-	{
-		//Set next send time
-		next = (DWORD)-1;
+	//Next tick
+	now++;
+
+	//Get slot in first level
+	DWORD index = now & (Level0Size-1);
 
-		//For each timer
-		for(ListTimers::iterator it=lstTimers.begin(); it!=lstTimers.end(); it++)
+	//If we have wrapped cascade upper levels
+	if (!index)
+	{
+		//For each level
+		for (int i=0;i<Levels;i++)
 		{
-			//Get data pointer
-			Data *d = (*it);
-
-			//If it's not set
-			if (!d->set)
-				continue;
-
-			//If it's time for trigger
-			if (d->when<=next)
-			{
-				//Launch trigger
-				d->handler(d->data);
-				//Unset
-				d->set = 0;
-			} else if (d->when<next) {
-				//Calc new min time
-				next = d->when;
-			}
+			//Get index in level
+			DWORD j = (now>>(Level0Bits+i*LevelBits)) & (LevelSize-1);
+			//Move its timers down
+			Cascade(&wheel[i][j]);
+			//If it has not wrapped don't go up
+			if (j)
+				break;
 		}
-		
 	}
-	//Return current time
-	return time;
+
+	//Fire the timers in the slot, handlers may set or reset any timer
+	while (wheel0[index])
+	{
+		//Get first
+		Data *d = wheel0[index];
+		//Remove it
+		Remove(d);
+		//Launch
+		d->handler(d->data,d->id);
+		//Inc
+		fired++;
+	}
+
+	return fired;
 }
 
-Timer::Handle Timer::CreateTimer(Handler handler,void *data)
+DWORD Timer::Tick(DWORD ms)
 {
-	//Create timer
-	return (Handle) new Data(handler,data);
+	DWORD fired = 0;
+
+	//Add to the time not yet ticked
+	rest += ms;
+
+	//For each tick
+	while (rest>=resolution)
+	{
+		//Decrease first so handlers see the right time
+		rest -= resolution;
+		//Step
+		fired += Step();
+	}
+
+	//Return expired timers
+	return fired;
+}
+
+DWORD Timer::GetTime()
+{
+	//Return current time in ms
+	return now*resolution + rest;
+}
+
+Timer::Handle Timer::CreateTimer(Handler handler,void *data,int id)
+{
+	//Create data
+	Data *d = new Data();
+
+	//Set values
+	d->handler = handler;
+	d->data = data;
+	d->id = id;
+	d->when = 0;
+	d->next = NULL;
+	d->pprev = NULL;
+
+	return (Handle) d;
 }
 
 void Timer::SetTimer(Handle id,DWORD ms)
 {
-	//Set new timer
-	((Data*)id)->Set(time+ms);
-
-	//Reset next time for timer
-	next = (DWORD)-1;
-
-	//For each timer
-	for(ListTimers::iterator it=lstTimers.begin(); it!=lstTimers.end(); it++)
-		//If its new min
-		if ((*it)->when<next)
-			//Calc new min time
-			next = (*it)->when;
+	Data *d = (Data*)id;
+
+	//If it was set
+	if (d->pprev)
+		//Remove it
+		Remove(d);
+
+	//Get ticks rounding up, at least the next one
+	DWORD ticks = (ms+rest+resolution-1)/resolution;
+
+	//Set expiration
+	d->when = now + (ticks ? ticks : 1);
+
+	//Add to wheel
+	Add(d);
 }
 
 void Timer::ResetTimer(Handle id)
 {
-	//Reset
-	((Data *)id)->Reset();
-	//For each timer
-	for(ListTimers::iterator it=lstTimers.begin(); it!=lstTimers.end(); it++)
-		//If its new min
-		if ((*it)->when<next)
-			//Calc new min time
-			next = (*it)->when;
+	Data *d = (Data*)id;
+
+	//If it is set
+	if (d->pprev)
+		//Remove it
+		Remove(d);
+}
+
+int Timer::IsSet(Handle id)
+{
+	//Set if it's linked in a slot
+	return ((Data*)id)->pprev!=NULL;
 }
 
 void Timer::DestroyTimer(Handle id)
 {
+	//Reset it first
+	ResetTimer(id);
+	//Delete
 	delete (Data *)id;
 }
@@ -1,45 +1,67 @@
 #ifndef _TIMER_H_
 #define _TIMER_H_
 
-#include "H223Const.h"
-#include <list>
-using namespace std;
+#include "H324MConfig.h"
 
+/**********************************
+* Timer
+*	Hierarchical timer wheel. Time only advances with Tick, so it can be
+*	driven by the session clock. Timers expire with a resolution of
+*	resolution ms, arming and cancelling a timer is O(1) and each tick
+*	only looks at one slot, cascading the upper levels when it wraps.
+***********************************/
 class Timer
 {
 public:
-	typedef void*(*Handler)(void*);
+	typedef void (*Handler)(void *data,int id);
 	typedef void* Handle;
+
 private:
 	struct Data
 	{
-		Handler handler;
-		void *	data;
-		bool	set;
+		Handler	handler;
+		void*	data;
+		int	id;
 		DWORD	when;
+		Data*	next;
+		Data**	pprev;
+	};
 
-		Data(Handler h,void* d);		
-		void Set(DWORD t);
-		void Reset();
+	enum {
+		Level0Bits	= 8,
+		LevelBits	= 6,
+		Level0Size	= 1<<Level0Bits,
+		LevelSize	= 1<<LevelBits,
+		Levels		= 3,
+		MaxTicks	= 1<<(Level0Bits+Levels*LevelBits)
 	};
-	
-	typedef list<Data*> ListTimers;
+
 public:
-	Timer();
-	virtual ~Timer();
+	Timer(DWORD resolution = 10);
+	~Timer();
 
-	DWORD Tick(int ms);
+	//Advance the time and fire the expired timers, returns how many
+	DWORD Tick(DWORD ms);
+	DWORD GetTime();
 
-	Handle CreateTimer(Handler handler,void *data);
+	Handle CreateTimer(Handler handler,void *data,int id = 0);
 	void SetTimer(Handle id,DWORD ms);
 	void ResetTimer(Handle id);
+	int  IsSet(Handle id);
 	void DestroyTimer(Handle id);
 
 private:
-	DWORD time;
-	DWORD next;
-	ListTimers lstTimers;
-};
+	void Add(Data *d);
+	void Remove(Data *d);
+	void Cascade(Data **slot);
+	DWORD Step();
 
+private:
+	Data*	wheel0[Level0Size];
+	Data*	wheel[Levels][LevelSize];
+	DWORD	resolution;
+	DWORD	now;
+	DWORD	rest;
+};
 
 #endif
@@ -0,0 +1,461 @@
+/* H324M library
+ *
+ * Copyright (C) 2006 Sergio Garcia Murillo
+ *
+ * sergio.garcia@fontventa.com
+ * http://sip.fontventa.com
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <pthread.h>
+#include "TraceBuffer.h"
+
+//Number of the files opened by this process
+static DWORD files = 0;
+
+//The writer shared by all the buffers and the ones it drains
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t cond = PTHREAD_COND_INITIALIZER;
+static TraceBuffer *buffers = NULL;
+static TraceBuffer *draining = NULL;
+static int writing = false;
+//The running writer, it exits when its generation is not the current one
+static pthread_t writer;
+static DWORD generation = 0;
+
+TraceBuffer::TraceBuffer(DWORD s,DWORD max)
+{
+	//Store sizes, ring size must be a power of two
+	size = 1;
+	while (size<s)
+		size <<= 1;
+	maxFileSize = max;
+	//Nothing yet, allocated on first use
+	ring = NULL;
+	head = 0;
+	tail = 0;
+	failed = false;
+	full = false;
+	enabled = false;
+	started = false;
+	registered = false;
+	fd = -1;
+	written = 0;
+	dropped = 0;
+	prev = NULL;
+	next = NULL;
+}
+
+TraceBuffer::~TraceBuffer()
+{
+	//If the writer was draining us
+	if (registered)
+	{
+		//Stop it
+		Unregister();
+		//Write the rest
+		Drain();
+	}
+
+	//Close file
+	if (fd!=-1)
+		close(fd);
+
+	//Free ring
+	free(ring);
+}
+
+void TraceBuffer::SetEnabled(int e)
+{
+	enabled = e;
+}
+
+DWORD TraceBuffer::GetDropped()
+{
+	return dropped;
+}
+
+int TraceBuffer::Start()
+{
+	char name[256];
+
+	//Only once
+	started = true;
+
+	//Open file, the address could be reused by a later session so use our own number
+	sprintf(name,"/tmp/h324m_%d_%u.trace",getpid(),__sync_fetch_and_add(&files,1));
+	fd = open(name,O_CREAT|O_WRONLY|O_TRUNC, S_IRUSR | S_IWUSR );
+
+	//Check
+	if (fd==-1)
+		//Don't try again
+		return !(failed = true);
+
+	//Allocate ring
+	ring = (BYTE*)malloc(size);
+
+	//Check
+	if (!ring)
+		//Don't try again
+		return !(failed = true);
+
+	//Let the writer drain us
+	if (!Register())
+		//Don't try again
+		return !(failed = true);
+
+	//Running
+	return 1;
+}
+
+int TraceBuffer::Register()
+{
+	int ret = 1;
+
+	//Lock
+	pthread_mutex_lock(&mutex);
+
+	//Add us to the list
+	prev = NULL;
+	next = buffers;
+	if (buffers)
+		buffers->prev = this;
+	buffers = this;
+	registered = true;
+
+	//If the writer is not running
+	if (!writing)
+	{
+		//Start it with the current generation
+		if (!pthread_create(&writer,NULL,Run,(void*)(long)generation))
+		{
+			//Running, it's joined when the last buffer is removed
+			writing = true;
+		} else {
+			//Remove us
+			buffers = next;
+			if (next)
+				next->prev = NULL;
+			registered = false;
+			//Failed
+			ret = 0;
+		}
+	}
+
+	//Unlock
+	pthread_mutex_unlock(&mutex);
+
+	return ret;
+}
+
+void TraceBuffer::Unregister()
+{
+	pthread_t thread;
+	int join = false;
+
+	//Lock
+	pthread_mutex_lock(&mutex);
+
+	//Wait until the writer is done with us
+	while (draining==this)
+		pthread_cond_wait(&cond,&mutex);
+
+	//Remove us from the list
+	if (prev)
+		prev->next = next;
+	else
+		buffers = next;
+	if (next)
+		next->prev = prev;
+	registered = false;
+
+	//If it was the last one
+	if (!buffers && writing)
+	{
+		//Tell the writer to exit, a new one is started for the next buffer
+		generation++;
+		writing = false;
+		//Join it after unlocking
+		thread = writer;
+		join = true;
+		//Wake it
+		pthread_cond_broadcast(&cond);
+	}
+
+	//Unlock
+	pthread_mutex_unlock(&mutex);
+
+	//Wait for it so no code of ours is running once the last session is gone
+	if (join)
+		pthread_join(thread,NULL);
+}
+
+void TraceBuffer::Copy(DWORD pos,const BYTE *data,DWORD length)
+{
+	//Get position in ring
+	DWORD i = pos & (size-1);
+
+	//Get contiguous part
+	DWORD n = size-i;
+
+	//If it doesn't wrap
+	if (length<=n)
+	{
+		//Copy all
+		memcpy(ring+i,data,length);
+	} else {
+		//Copy until the end
+		memcpy(ring+i,data,n);
+		//And the rest at the begining
+		memcpy(ring,data+n,length-n);
+	}
+}
+
+int TraceBuffer::Append(DWORD source,BYTE type,BYTE extra,const BYTE *data,WORD length)
+{
+	BYTE header[8];
+
+	//If the file is full or the writer failed don't copy anything
+	if (full || failed)
+	{
+		//Dropped
+		__sync_fetch_and_add(&dropped,1);
+		return 0;
+	}
+
+	//Start writer on first record
+	if (!started && !Start())
+	{
+		//Dropped
+		__sync_fetch_and_add(&dropped,1);
+		return 0;
+	}
+
+	//Get used space, tail is only moved forward by the writer
+	DWORD used = head-tail;
+
+	//Check free space
+	if (size-used<sizeof(header)+length)
+	{
+		//Don't wait for it
+		__sync_fetch_and_add(&dropped,1);
+		return 0;
+	}
+
+	//Build header
+	memcpy(header,&source,4);
+	header[4] = type;
+	header[5] = extra;
+	memcpy(header+6,&length,2);
+
+	//Copy record
+	Copy(head,header,sizeof(header));
+	Copy(head+sizeof(header),data,length);
+
+	//Make the data visible before publishing it
+	__sync_synchronize();
+
+	//Publish, the writer gets it on its next pass
+	head += sizeof(header)+length;
+
+	//Appended
+	return 1;
+}
+
+DWORD TraceBuffer::GetRecordLength(DWORD pos)
+{
+	WORD length;
+	BYTE *b = (BYTE*)&length;
+
+	//Get the length from the header, it could wrap
+	b[0] = ring[(pos+6) & (size-1)];
+	b[1] = ring[(pos+7) & (size-1)];
+
+	//Header and data
+	return 8+length;
+}
+
+DWORD TraceBuffer::CountRecords(DWORD pos,DWORD from,DWORD end)
+{
+	DWORD num = 0;
+
+	//Walk the headers from the first one
+	while (pos!=end)
+	{
+		//Next one
+		pos += GetRecordLength(pos);
+		//If it ends after from
+		if ((int)(pos-from)>0)
+			//Count it
+			num++;
+	}
+
+	return num;
+}
+
+int TraceBuffer::Write(DWORD pos,DWORD length,DWORD *done)
+{
+	//Nothing yet
+	*done = 0;
+
+	//Until all written
+	while (length)
+	{
+		//Get position in ring
+		DWORD i = pos & (size-1);
+
+		//Get contiguous part
+		DWORD n = size-i;
+		if (n>length)
+			n = length;
+
+		//Write
+		int len = write(fd,ring+i,n);
+
+		//If interrupted
+		if (len==-1 && errno==EINTR)
+			//Try again
+			continue;
+
+		//If failed
+		if (len<=0)
+			return 0;
+
+		//Increase size
+		written += len;
+		*done += len;
+
+		//Move
+		pos += len;
+		length -= len;
+	}
+
+	//Written
+	return 1;
+}
+
+void TraceBuffer::Drain()
+{
+	//Get pending data
+	DWORD end = head;
+
+	//Read data after reading head
+	__sync_synchronize();
+
+	//Nothing to do
+	if (tail==end)
+		return;
+
+	//The whole records that fit under the cap
+	DWORD n = 0;
+
+	//If we can still write
+	if (!full && !failed)
+	{
+		//Get them
+		while (tail+n!=end)
+		{
+			//Get next record
+			DWORD length = GetRecordLength(tail+n);
+			//If it doesn't fit
+			if (written+n+length>maxFileSize)
+			{
+				//Full, stop copying them
+				full = true;
+				break;
+			}
+			//Add it
+			n += length;
+		}
+	}
+
+	//Write them
+	DWORD done = n;
+	if (n && !Write(tail,n,&done))
+		//Don't write anymore, the records in the file would be corrupted
+		failed = true;
+
+	//Count the records not fully written, the ones over the cap too
+	DWORD lost = 0;
+	if (tail+done!=end)
+		lost = CountRecords(tail,tail+done,end);
+
+	//Count them
+	if (lost)
+		__sync_fetch_and_add(&dropped,lost);
+
+	//Done with the data before releasing it
+	__sync_synchronize();
+
+	//Free it
+	tail = end;
+}
+
+void* TraceBuffer::Run(void *param)
+{
+	DWORD gen = (DWORD)(long)param;
+	struct timeval tv;
+	struct timespec ts;
+
+	//Lock
+	pthread_mutex_lock(&mutex);
+
+	//Until told to exit
+	while (gen==generation)
+	{
+		//Drain each one
+		for (TraceBuffer *trace = buffers; trace && gen==generation; trace = trace->next)
+		{
+			//It can't be removed while we are on it
+			draining = trace;
+			//Write without the lock so nobody waits for the disk
+			pthread_mutex_unlock(&mutex);
+			trace->Drain();
+			pthread_mutex_lock(&mutex);
+			//Done
+			draining = NULL;
+			//Wake the ones waiting to remove it
+			pthread_cond_broadcast(&cond);
+		}
+
+		//Poll again in 20ms, the cond only wakes us to exit
+		if (gen!=generation)
+			break;
+		gettimeofday(&tv,NULL);
+		ts.tv_sec = tv.tv_sec;
+		ts.tv_nsec = tv.tv_usec*1000+20000000;
+		if (ts.tv_nsec>=1000000000)
+		{
+			ts.tv_sec++;
+			ts.tv_nsec -= 1000000000;
+		}
+		pthread_cond_timedwait(&cond,&mutex,&ts);
+	}
+
+	//Unlock
+	pthread_mutex_unlock(&mutex);
+
+	//Exit
+	return NULL;
+}
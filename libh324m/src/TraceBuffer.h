@@ -0,0 +1,86 @@
+#ifndef _TRACEBUFFER_H_
+#define _TRACEBUFFER_H_
+
+#include "H324MConfig.h"
+
+/**********************************
+* TraceBuffer
+*	Per session ring buffer of binary trace records. The session thread
+*	appends records without locking, and a single writer thread shared
+*	by all the buffers of the process drains each of them to its own
+*	file (/tmp/h324m_<pid>_<number>.trace). Only whole records are
+*	written, and once the next one doesn't fit under the size cap the
+*	buffer is full and the rest are dropped without being copied.
+*	If the writer can't keep up records are dropped, never waited for,
+*	and if writing fails the rest of them are dropped too.
+*	The writer polls the buffers every 20ms. It's started with the first
+*	buffer and joined when the last one is destroyed, so it's not left
+*	running once all the sessions are gone and the module is unloaded.
+*
+*	Each record is a 8 bytes header followed by length bytes of data:
+*		DWORD source	logger that wrote it
+*		BYTE  type	one of Type
+*		BYTE  extra	column offset for e_DemuxInfo
+*		WORD  length
+*	All values in host byte order.
+*	The e_H245 records are the text of the H.245 messages and events.
+***********************************/
+class TraceBuffer
+{
+public:
+	enum Type {
+		e_MuxBytes	= 1,
+		e_MuxInfo	= 2,
+		e_DemuxBytes	= 3,
+		e_DemuxInfo	= 4,
+		e_MediaInput	= 5,
+		e_MediaOutput	= 6,
+		e_Input		= 7,
+		e_Output	= 8,
+		e_H245Input	= 9,
+		e_H245Output	= 10,
+		e_H245Event	= 11
+	};
+
+public:
+	TraceBuffer(DWORD size = 256*1024, DWORD maxFileSize = 64*1024*1024);
+	~TraceBuffer();
+
+	//Enable tracing even if log level is lower than 5
+	void SetEnabled(int enabled);
+	int  IsEnabled()	{ return enabled; }
+
+	int Append(DWORD source,BYTE type,BYTE extra,const BYTE *data,WORD length);
+
+	DWORD GetDropped();
+
+private:
+	int  Start();
+	void Copy(DWORD pos,const BYTE *data,DWORD length);
+	void Drain();
+	int  Write(DWORD pos,DWORD length,DWORD *done);
+	DWORD GetRecordLength(DWORD pos);
+	DWORD CountRecords(DWORD pos,DWORD from,DWORD end);
+	int  Register();
+	void Unregister();
+	static void* Run(void *param);
+
+private:
+	BYTE*		ring;
+	DWORD		size;
+	volatile DWORD	head;
+	volatile DWORD	tail;
+	volatile int	failed;
+	volatile int	full;
+	int		enabled;
+	int		started;
+	int		registered;
+	int		fd;
+	DWORD		written;
+	DWORD		maxFileSize;
+	volatile DWORD	dropped;
+	TraceBuffer*	prev;
+	TraceBuffer*	next;
+};
+
+#endif
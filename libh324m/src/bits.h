@@ -0,0 +1,20 @@
+#ifndef _BITS_H_
+#define _BITS_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Bit reversed value of each byte */
+extern const unsigned char TIFFBitRevTable[256];
+
+/* Reverse the bits of each byte, in place or into another buffer */
+void TIFFReverseBits(unsigned char* buffer,int length);
+void TIFFReverseBitsCopy(unsigned char* dst,const unsigned char* src,int length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
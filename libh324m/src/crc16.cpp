@@ -67,16 +67,58 @@ static const WORD crc16_table[256] =
  0x7BC7, 0x6A4E, 0x58D5, 0x495C, 0x3DE3, 0x2C6A, 0x1EF1, 0x0F78
 };
 
+/*****************************************************************
+ *
+ * Slice by 8 tables, crc16_slice[k][i] is the crc of byte i
+ * followed by k zero bytes so 8 bytes can be added with 8
+ * independent lookups instead of a chain of 8 dependent ones.
+ *
+ *****************************************************************/
+static WORD crc16_slice[8][256];
+
+static struct CRC16Slice
+{
+	CRC16Slice()
+	{
+		//First one is the byte table
+		for (int i=0;i<256;i++)
+			crc16_slice[0][i] = crc16_table[i];
+		//Each one adds a zero byte to the previous
+		for (int k=1;k<8;k++)
+			for (int i=0;i<256;i++)
+				crc16_slice[k][i] = crc16_table[crc16_slice[k-1][i] & 0xff] ^ (crc16_slice[k-1][i] >> 8);
+	}
+} crc16_slice_init;
 
 CRC16::CRC16()
 {
 	//Initialize
 	crc = 0xFFFF;
 }
-void CRC16::Add(BYTE *buffer,int len)
+void CRC16::Add(const BYTE *buffer,int len)
 {
+	WORD c = crc;
+
+	//Add 8 bytes at a time
+	while (len>=8)
+	{
+		c =	crc16_slice[7][(c ^ buffer[0]) & 0xff] ^
+			crc16_slice[6][((c >> 8) ^ buffer[1]) & 0xff] ^
+			crc16_slice[5][buffer[2]] ^
+			crc16_slice[4][buffer[3]] ^
+			crc16_slice[3][buffer[4]] ^
+			crc16_slice[2][buffer[5]] ^
+			crc16_slice[1][buffer[6]] ^
+			crc16_slice[0][buffer[7]];
+		buffer += 8;
+		len -= 8;
+	}
+
+	//Add the rest
 	for(int i=0;i<len;i++)
-		crc = crc16_table[(crc ^ buffer[i]) & 0xff] ^ (crc >> 8);
+		c = crc16_table[(c ^ buffer[i]) & 0xff] ^ (c >> 8);
+
+	crc = c;
 }
 void CRC16::Add(BYTE b)
 {
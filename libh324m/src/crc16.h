@@ -7,7 +7,7 @@ class CRC16
 {
 public:
 	CRC16();
-	void Add(BYTE *buffer,int len);
+	void Add(const BYTE *buffer,int len);
 	void Add(BYTE b);
 	WORD Calc();
 private:
@@ -50,6 +50,23 @@ BYTE crc8_table[256] = {
 0x59, 0xc8, 0xbd, 0x2c, 0x5e, 0xcf
 };
 
+/* Slice by 8 tables, crc8_slice[k][i] is the crc of byte i followed by k
+ * zero bytes */
+static BYTE crc8_slice[8][256];
+
+static struct CRC8Slice
+{
+	CRC8Slice()
+	{
+		//First one is the byte table
+		for (int i=0;i<256;i++)
+			crc8_slice[0][i] = crc8_table[i];
+		//Each one adds a zero byte to the previous
+		for (int k=1;k<8;k++)
+			for (int i=0;i<256;i++)
+				crc8_slice[k][i] = crc8_table[crc8_slice[k-1][i]];
+	}
+} crc8_slice_init;
 
 CRC8::CRC8()
 {
@@ -58,8 +75,28 @@ CRC8::CRC8()
 
 void CRC8::Add(BYTE *buffer,int len)
 {
+	BYTE c = crc;
+
+	//Add 8 bytes at a time
+	while (len>=8)
+	{
+		c =	crc8_slice[7][c ^ buffer[0]] ^
+			crc8_slice[6][buffer[1]] ^
+			crc8_slice[5][buffer[2]] ^
+			crc8_slice[4][buffer[3]] ^
+			crc8_slice[3][buffer[4]] ^
+			crc8_slice[2][buffer[5]] ^
+			crc8_slice[1][buffer[6]] ^
+			crc8_slice[0][buffer[7]];
+		buffer += 8;
+		len -= 8;
+	}
+
+	//Add the rest
 	for(int i=0;i<len;i++)
-		crc = crc8_table[(crc ^ buffer[i]) & 0xff];
+		c = crc8_table[(c ^ buffer[i]) & 0xff];
+
+	crc = c;
 }
 void CRC8::Add(BYTE b)
 {
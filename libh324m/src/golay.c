@@ -57,62 +57,576 @@
 
    I've seen cunning implementations of this which only use one table. That
    technique doesn't seem to work with these numbers though.
+
+   The rows of the encoding matrix (for MC1..MPL8) are
+
+	0xC75, 0x49F, 0xD4B, 0x6E3, 0x9B3, 0xB66,
+	0xECC, 0x1ED, 0x3DA, 0x7B4, 0xB1D, 0xE3A
+
+   and the ones of the inverse matrix
+
+	0x49F, 0x93E, 0x6E3, 0xDC6, 0xF13, 0xAB9,
+	0x1ED, 0x3DA, 0x7B4, 0xF68, 0xA4F, 0xC75
+
+   Instead of xoring them bit by bit, the coding is looked up in two tables
+   of 64 entries, one for the low 6 bits of the word and one for the high 6.
 */
 
-static const guint golay_encode_matrix[12] = {
-    0xC75,
-    0x49F,
-    0xD4B,
-    0x6E3,
-    0x9B3,
-    0xB66,
-    0xECC,
-    0x1ED,
-    0x3DA,
-    0x7B4,
-    0xB1D,
-    0xE3A,
+static const guint golay_encode_low[64] = {
+    0x000, 0xC75, 0x49F, 0x8EA, 0xD4B, 0x13E, 0x9D4, 0x5A1,
+    0x6E3, 0xA96, 0x27C, 0xE09, 0xBA8, 0x7DD, 0xF37, 0x342,
+    0x9B3, 0x5C6, 0xD2C, 0x159, 0x4F8, 0x88D, 0x067, 0xC12,
+    0xF50, 0x325, 0xBCF, 0x7BA, 0x21B, 0xE6E, 0x684, 0xAF1,
+    0xB66, 0x713, 0xFF9, 0x38C, 0x62D, 0xA58, 0x2B2, 0xEC7,
+    0xD85, 0x1F0, 0x91A, 0x56F, 0x0CE, 0xCBB, 0x451, 0x824,
+    0x2D5, 0xEA0, 0x64A, 0xA3F, 0xF9E, 0x3EB, 0xB01, 0x774,
+    0x436, 0x843, 0x0A9, 0xCDC, 0x97D, 0x508, 0xDE2, 0x197,
 };
 
-static const guint golay_decode_matrix[12] = {
-   0x49F,
-   0x93E,
-   0x6E3,
-   0xDC6,
-   0xF13,
-   0xAB9,
-   0x1ED,
-   0x3DA,
-   0x7B4,
-   0xF68,
-   0xA4F,
-   0xC75,
+static const guint golay_encode_high[64] = {
+    0x000, 0xECC, 0x1ED, 0xF21, 0x3DA, 0xD16, 0x237, 0xCFB,
+    0x7B4, 0x978, 0x659, 0x895, 0x46E, 0xAA2, 0x583, 0xB4F,
+    0xB1D, 0x5D1, 0xAF0, 0x43C, 0x8C7, 0x60B, 0x92A, 0x7E6,
+    0xCA9, 0x265, 0xD44, 0x388, 0xF73, 0x1BF, 0xE9E, 0x052,
+    0xE3A, 0x0F6, 0xFD7, 0x11B, 0xDE0, 0x32C, 0xC0D, 0x2C1,
+    0x98E, 0x742, 0x863, 0x6AF, 0xA54, 0x498, 0xBB9, 0x575,
+    0x527, 0xBEB, 0x4CA, 0xA06, 0x6FD, 0x831, 0x710, 0x9DC,
+    0x293, 0xC5F, 0x37E, 0xDB2, 0x149, 0xF85, 0x0A4, 0xE68,
 };
 
 
+/* As the error pattern only depends on the syndrome, it's precalculated for
+ * all the 4096 syndromes with the original decoder:
+ *
+ *  - up to 3 errors in the parity bits: the syndrome itself
+ *  - 1 error in the data bits and up to 2 in the parity bits
+ *  - up to 3 errors in the data bits: the inverse of the syndrome
+ *  - 2 errors in the data bits and 1 in the parity bits
+ *  - otherwise it's uncorrectable (-1)
+ *
+ * so decoding takes the same time for any codeword, even for the false
+ * candidates tried while hunting for a header.
+ */
+static const gint32 golay_errors_table[4096] = {
+    0x000000, 0x001000, 0x002000, 0x003000, 0x004000, 0x005000, 0x006000, 0x007000,
+    0x008000, 0x009000, 0x00A000, 0x00B000, 0x00C000, 0x00D000, 0x00E000,       -1,
+    0x010000, 0x011000, 0x012000, 0x013000, 0x014000, 0x015000, 0x016000,       -1,
+    0x018000, 0x019000, 0x01A000,       -1, 0x01C000,       -1,       -1, 0x480002,
+    0x020000, 0x021000, 0x022000, 0x023000, 0x024000, 0x025000, 0x026000,       -1,
+    0x028000, 0x029000, 0x02A000,       -1, 0x02C000,       -1,       -1, 0x800048,
+    0x030000, 0x031000, 0x032000,       -1, 0x034000,       -1,       -1, 0x200180,
+    0x038000,       -1,       -1, 0x040420,       -1, 0x000A10, 0x100005,       -1,
+    0x040000, 0x041000, 0x042000, 0x043000, 0x044000, 0x045000, 0x046000,       -1,
+    0x048000, 0x049000, 0x04A000,       -1, 0x04C000,       -1,       -1, 0x200801,
+    0x050000, 0x051000, 0x052000,       -1, 0x054000,       -1,       -1, 0x100208,
+    0x058000,       -1,       -1, 0x020420,       -1, 0x000144, 0x800090,       -1,
+    0x060000, 0x061000, 0x062000,       -1, 0x064000,       -1,       -1, 0x000016,
+    0x068000,       -1,       -1, 0x010420,       -1, 0x180080, 0x400300,       -1,
+    0x070000,       -1,       -1, 0x008420,       -1, 0xC00001, 0x080840,       -1,
+          -1, 0x002420, 0x001420, 0x000420, 0x20000A,       -1,       -1, 0x004420,
+    0x080000, 0x081000, 0x082000, 0x083000, 0x084000, 0x085000, 0x086000,       -1,
+    0x088000, 0x089000, 0x08A000,       -1, 0x08C000,       -1,       -1, 0x410002,
+    0x090000, 0x091000, 0x092000,       -1, 0x094000,       -1,       -1, 0x408002,
+    0x098000,       -1,       -1, 0x404002,       -1, 0x402002, 0x401002, 0x400002,
+    0x0A0000, 0x0A1000, 0x0A2000,       -1, 0x0A4000,       -1,       -1, 0x000221,
+    0x0A8000,       -1,       -1, 0x000904,       -1, 0x140080, 0x200410,       -1,
+    0x0B0000,       -1,       -1, 0x900010,       -1, 0x00040C, 0x040840,       -1,
+          -1, 0x200041, 0x000288,       -1, 0x800120,       -1,       -1, 0x420002,
+    0x0C0000, 0x0C1000, 0x0C2000,       -1, 0x0C4000,       -1,       -1, 0x800500,
+    0x0C8000,       -1,       -1, 0x000250,       -1, 0x120080, 0x00002C,       -1,
+    0x0D0000,       -1,       -1, 0x000085,       -1, 0x200030, 0x020840,       -1,
+          -1, 0x800808, 0x300100,       -1, 0x000601,       -1,       -1, 0x440002,
+    0x0E0000,       -1,       -1, 0x600008,       -1, 0x108080, 0x010840,       -1,
+          -1, 0x104080, 0x800003,       -1, 0x101080, 0x100080,       -1, 0x102080,
+          -1, 0x000302, 0x004840,       -1, 0x002840,       -1, 0x000840, 0x001840,
+    0x400014,       -1,       -1, 0x080420,       -1, 0x110080, 0x008840,       -1,
+    0x100000, 0x101000, 0x102000, 0x103000, 0x104000, 0x105000, 0x106000,       -1,
+    0x108000, 0x109000, 0x10A000,       -1, 0x10C000,       -1,       -1, 0x000130,
+    0x110000, 0x111000, 0x112000,       -1, 0x114000,       -1,       -1, 0x040208,
+    0x118000,       -1,       -1, 0x0008C0,       -1, 0xA00400, 0x020005,       -1,
+    0x120000, 0x121000, 0x122000,       -1, 0x124000,       -1,       -1, 0x400C00,
+    0x128000,       -1,       -1, 0x200202,       -1, 0x0C0080, 0x010005,       -1,
+    0x130000,       -1,       -1, 0x880010,       -1, 0x000062, 0x008005,       -1,
+          -1, 0x400108, 0x004005,       -1, 0x002005,       -1, 0x000005, 0x001005,
+    0x140000, 0x141000, 0x142000,       -1, 0x144000,       -1,       -1, 0x010208,
+    0x148000,       -1,       -1, 0xC00004,       -1, 0x0A0080, 0x000442,       -1,
+    0x150000,       -1,       -1, 0x004208,       -1, 0x002208, 0x001208, 0x000208,
+          -1, 0x000013, 0x280100,       -1, 0x400820,       -1,       -1, 0x008208,
+    0x160000,       -1,       -1, 0x000141,       -1, 0x088080, 0xA00020,       -1,
+          -1, 0x084080, 0x000818,       -1, 0x081080, 0x080080,       -1, 0x082080,
+          -1, 0x200804, 0x400082,       -1, 0x000510,       -1,       -1, 0x020208,
+    0x800240,       -1,       -1, 0x100420,       -1, 0x090080, 0x040005,       -1,
+    0x180000, 0x181000, 0x182000,       -1, 0x184000,       -1,       -1, 0x200044,
+    0x188000,       -1,       -1, 0x000409,       -1, 0x060080, 0x800A00,       -1,
+    0x190000,       -1,       -1, 0x820010,       -1, 0x000901, 0x0004A0,       -1,
+          -1, 0x000224, 0x240100,       -1, 0x000058,       -1,       -1, 0x500002,
+    0x1A0000,       -1,       -1, 0x810010,       -1, 0x048080, 0x00010A,       -1,
+          -1, 0x044080, 0x400060,       -1, 0x041080, 0x040080,       -1, 0x042080,
+          -1, 0x802010, 0x801010, 0x800010, 0x600200,       -1,       -1, 0x804010,
+    0x000C02,       -1,       -1, 0x808010,       -1, 0x050080, 0x080005,       -1,
+    0x1C0000,       -1,       -1, 0x000822,       -1, 0x028080, 0x400011,       -1,
+          -1, 0x024080, 0x210100,       -1, 0x021080, 0x020080,       -1, 0x022080,
+          -1, 0x400440, 0x208100,       -1, 0x800006,       -1,       -1, 0x080208,
+    0x202100,       -1, 0x200100, 0x201100,       -1, 0x030080, 0x204100,       -1,
+          -1, 0x00C080, 0x000604,       -1, 0x009080, 0x008080,       -1, 0x00A080,
+    0x005080, 0x004080,       -1, 0x006080, 0x001080, 0x000080, 0x003080, 0x002080,
+    0x000029,       -1,       -1, 0x840010,       -1, 0x018080, 0x100840,       -1,
+          -1, 0x014080, 0x220100,       -1, 0x011080, 0x010080,       -1, 0x012080,
+    0x200000, 0x201000, 0x202000, 0x203000, 0x204000, 0x205000, 0x206000,       -1,
+    0x208000, 0x209000, 0x20A000,       -1, 0x20C000,       -1,       -1, 0x040801,
+    0x210000, 0x211000, 0x212000,       -1, 0x214000,       -1,       -1, 0x020180,
+    0x218000,       -1,       -1, 0x00001C,       -1, 0x900400, 0x000260,       -1,
+    0x220000, 0x221000, 0x222000,       -1, 0x224000,       -1,       -1, 0x010180,
+    0x228000,       -1,       -1, 0x100202,       -1, 0x400024, 0x080410,       -1,
+    0x230000,       -1,       -1, 0x004180,       -1, 0x002180, 0x001180, 0x000180,
+          -1, 0x080041, 0xC00800,       -1, 0x04000A,       -1,       -1, 0x008180,
+    0x240000, 0x241000, 0x242000,       -1, 0x244000,       -1,       -1, 0x008801,
+    0x248000,       -1,       -1, 0x004801,       -1, 0x002801, 0x001801, 0x000801,
+    0x250000,       -1,       -1, 0x800042,       -1, 0x080030, 0x400404,       -1,
+          -1, 0x400280, 0x180100,       -1, 0x02000A,       -1,       -1, 0x010801,
+    0x260000,       -1,       -1, 0x480008,       -1, 0x000640, 0x900020,       -1,
+          -1, 0x800110, 0x0000C4,       -1, 0x01000A,       -1,       -1, 0x020801,
+          -1, 0x100804, 0x000211,       -1, 0x00800A,       -1,       -1, 0x040180,
+    0x00400A,       -1,       -1, 0x200420, 0x00000A, 0x00100A, 0x00200A,       -1,
+    0x280000, 0x281000, 0x282000,       -1, 0x284000,       -1,       -1, 0x100044,
+    0x288000,       -1,       -1, 0x8000A0,       -1, 0x000308, 0x020410,       -1,
+    0x290000,       -1,       -1, 0x000E00,       -1, 0x040030, 0x800009,       -1,
+          -1, 0x020041, 0x140100,       -1, 0x000884,       -1,       -1, 0x600002,
+    0x2A0000,       -1,       -1, 0x440008,       -1, 0x800802, 0x008410,       -1,
+          -1, 0x010041, 0x004410,       -1, 0x002410,       -1, 0x000410, 0x001410,
+          -1, 0x008041, 0x000026,       -1, 0x500200,       -1,       -1, 0x080180,
+    0x001041, 0x000041,       -1, 0x002041,       -1, 0x004041, 0x010410,       -1,
+    0x2C0000,       -1,       -1, 0x420008,       -1, 0x010030, 0x000282,       -1,
+          -1, 0x000406, 0x110100,       -1, 0xC00040,       -1,       -1, 0x080801,
+          -1, 0x004030, 0x108100,       -1, 0x001030, 0x000030,       -1, 0x002030,
+    0x102100,       -1, 0x100100, 0x101100,       -1, 0x008030, 0x104100,       -1,
+          -1, 0x402008, 0x401008, 0x400008, 0x000105,       -1,       -1, 0x404008,
+    0x000A20,       -1,       -1, 0x408008,       -1, 0x300080, 0x040410,       -1,
+    0x800480,       -1,       -1, 0x410008,       -1, 0x020030, 0x200840,       -1,
+          -1, 0x040041, 0x120100,       -1, 0x08000A,       -1,       -1, 0x800204,
+    0x300000, 0x301000, 0x302000,       -1, 0x304000,       -1,       -1, 0x080044,
+    0x308000,       -1,       -1, 0x020202,       -1, 0x810400, 0x400088,       -1,
+    0x310000,       -1,       -1, 0x400021,       -1, 0x808400, 0x000812,       -1,
+          -1, 0x804400, 0x0C0100,       -1, 0x801400, 0x800400,       -1, 0x802400,
+    0x320000,       -1,       -1, 0x008202,       -1, 0x000019, 0x840020,       -1,
+          -1, 0x002202, 0x001202, 0x000202, 0x000940,       -1,       -1, 0x004202,
+          -1, 0x040804, 0x000448,       -1, 0x480200,       -1,       -1, 0x100180,
+    0x0000B0,       -1,       -1, 0x010202,       -1, 0x820400, 0x200005,       -1,
+    0x340000,       -1,       -1, 0x000490,       -1, 0x400102, 0x820020,       -1,
+          -1, 0x000068, 0x090100,       -1, 0x000214,       -1,       -1, 0x100801,
+          -1, 0x020804, 0x088100,       -1, 0x0000C1,       -1,       -1, 0x200208,
+    0x082100,       -1, 0x080100, 0x081100,       -1, 0x840400, 0x084100,       -1,
+          -1, 0x010804, 0x804020,       -1, 0x802020,       -1, 0x800020, 0x801020,
+    0x400401,       -1,       -1, 0x040202,       -1, 0x280080, 0x808020,       -1,
+    0x001804, 0x000804,       -1, 0x002804,       -1, 0x004804, 0x810020,       -1,
+          -1, 0x008804, 0x0A0100,       -1, 0x10000A,       -1,       -1, 0x400050,
+    0x380000,       -1,       -1, 0x004044,       -1, 0x002044, 0x001044, 0x000044,
+          -1, 0x400810, 0x050100,       -1, 0x000023,       -1,       -1, 0x008044,
+          -1, 0x00008A, 0x048100,       -1, 0x420200,       -1,       -1, 0x010044,
+    0x042100,       -1, 0x040100, 0x041100,       -1, 0x880400, 0x044100,       -1,
+          -1, 0x000520, 0x000881,       -1, 0x410200,       -1,       -1, 0x020044,
+    0x80000C,       -1,       -1, 0x080202,       -1, 0x240080, 0x100410,       -1,
+    0x404200,       -1,       -1, 0xA00010, 0x400200, 0x401200, 0x402200,       -1,
+          -1, 0x100041, 0x060100,       -1, 0x408200,       -1,       -1, 0x000828,
+          -1, 0x800201, 0x018100,       -1, 0x000C08,       -1,       -1, 0x040044,
+    0x012100,       -1, 0x010100, 0x011100,       -1, 0x220080, 0x014100,       -1,
+    0x00A100,       -1, 0x008100, 0x009100,       -1, 0x100030, 0x00C100,       -1,
+    0x002100, 0x003100, 0x000100, 0x001100, 0x006100,       -1, 0x004100, 0x005100,
+    0x000052,       -1,       -1, 0x500008,       -1, 0x208080, 0x880020,       -1,
+          -1, 0x204080, 0x030100,       -1, 0x201080, 0x200080,       -1, 0x202080,
+          -1, 0x080804, 0x028100,       -1, 0x440200,       -1,       -1, 0x000403,
+    0x022100,       -1, 0x020100, 0x021100,       -1, 0x210080, 0x024100,       -1,
+    0x400000, 0x401000, 0x402000, 0x403000, 0x404000, 0x405000, 0x406000,       -1,
+    0x408000, 0x409000, 0x40A000,       -1, 0x40C000,       -1,       -1, 0x090002,
+    0x410000, 0x411000, 0x412000,       -1, 0x414000,       -1,       -1, 0x088002,
+    0x418000,       -1,       -1, 0x084002,       -1, 0x082002, 0x081002, 0x080002,
+    0x420000, 0x421000, 0x422000,       -1, 0x424000,       -1,       -1, 0x100C00,
+    0x428000,       -1,       -1, 0x000091,       -1, 0x200024, 0x040300,       -1,
+    0x430000,       -1,       -1, 0x000244,       -1, 0x840001, 0x000038,       -1,
+          -1, 0x100108, 0xA00800,       -1, 0x0004C0,       -1,       -1, 0x0A0002,
+    0x440000, 0x441000, 0x442000,       -1, 0x444000,       -1,       -1, 0x0000E0,
+    0x448000,       -1,       -1, 0x900004,       -1, 0x000418, 0x020300,       -1,
+    0x450000,       -1,       -1, 0x000910,       -1, 0x820001, 0x200404,       -1,
+          -1, 0x200280, 0x000049,       -1, 0x100820,       -1,       -1, 0x0C0002,
+    0x460000,       -1,       -1, 0x280008,       -1, 0x810001, 0x008300,       -1,
+          -1, 0x000842, 0x004300,       -1, 0x002300,       -1, 0x000300, 0x001300,
+          -1, 0x804001, 0x100082,       -1, 0x801001, 0x800001,       -1, 0x802001,
+    0x080014,       -1,       -1, 0x400420,       -1, 0x808001, 0x010300,       -1,
+    0x480000, 0x481000, 0x482000,       -1, 0x484000,       -1,       -1, 0x018002,
+    0x488000,       -1,       -1, 0x014002,       -1, 0x012002, 0x011002, 0x010002,
+    0x490000,       -1,       -1, 0x00C002,       -1, 0x00A002, 0x009002, 0x008002,
+          -1, 0x006002, 0x005002, 0x004002, 0x003002, 0x002002, 0x001002, 0x000002,
+    0x4A0000,       -1,       -1, 0x240008,       -1, 0x000150, 0x800084,       -1,
+          -1, 0x800600, 0x100060,       -1, 0x000809,       -1,       -1, 0x030002,
+          -1, 0x0008A0, 0x000501,       -1, 0x300200,       -1,       -1, 0x028002,
+    0x040014,       -1,       -1, 0x024002,       -1, 0x022002, 0x021002, 0x020002,
+    0x4C0000,       -1,       -1, 0x220008,       -1, 0x000A04, 0x100011,       -1,
+          -1, 0x000121, 0x000C80,       -1, 0xA00040,       -1,       -1, 0x050002,
+          -1, 0x100440, 0x800220,       -1, 0x000188,       -1,       -1, 0x048002,
+    0x020014,       -1,       -1, 0x044002,       -1, 0x042002, 0x041002, 0x040002,
+          -1, 0x202008, 0x201008, 0x200008, 0x000422,       -1,       -1, 0x204008,
+    0x010014,       -1,       -1, 0x208008,       -1, 0x500080, 0x080300,       -1,
+    0x008014,       -1,       -1, 0x210008,       -1, 0x880001, 0x400840,       -1,
+    0x000014, 0x001014, 0x002014,       -1, 0x004014,       -1,       -1, 0x060002,
+    0x500000, 0x501000, 0x502000,       -1, 0x504000,       -1,       -1, 0x020C00,
+    0x508000,       -1,       -1, 0x840004,       -1, 0x000241, 0x200088,       -1,
+    0x510000,       -1,       -1, 0x200021,       -1, 0x000094, 0x800140,       -1,
+          -1, 0x020108, 0x000610,       -1, 0x040820,       -1,       -1, 0x180002,
+    0x520000,       -1,       -1, 0x004C00,       -1, 0x002C00, 0x001C00, 0x000C00,
+          -1, 0x010108, 0x080060,       -1, 0x800012,       -1,       -1, 0x008C00,
+          -1, 0x008108, 0x040082,       -1, 0x280200,       -1,       -1, 0x010C00,
+    0x001108, 0x000108,       -1, 0x002108,       -1, 0x004108, 0x400005,       -1,
+    0x540000,       -1,       -1, 0x808004,       -1, 0x200102, 0x080011,       -1,
+          -1, 0x802004, 0x801004, 0x800004, 0x010820,       -1,       -1, 0x804004,
+          -1, 0x080440, 0x020082,       -1, 0x008820,       -1,       -1, 0x400208,
+    0x004820,       -1,       -1, 0x810004, 0x000820, 0x001820, 0x002820,       -1,
+          -1, 0x000230, 0x010082,       -1, 0x00004C,       -1,       -1, 0x040C00,
+    0x200401,       -1,       -1, 0x820004,       -1, 0x480080, 0x100300,       -1,
+    0x002082,       -1, 0x000082, 0x001082,       -1, 0x900001, 0x004082,       -1,
+          -1, 0x040108, 0x008082,       -1, 0x020820,       -1,       -1, 0x200050,
+    0x580000,       -1,       -1, 0x000380,       -1, 0x800028, 0x040011,       -1,
+          -1, 0x200810, 0x020060,       -1, 0x000504,       -1,       -1, 0x110002,
+          -1, 0x040440, 0x00080C,       -1, 0x220200,       -1,       -1, 0x108002,
+    0x800081,       -1,       -1, 0x104002,       -1, 0x102002, 0x101002, 0x100002,
+          -1, 0x000007, 0x008060,       -1, 0x210200,       -1,       -1, 0x080C00,
+    0x002060,       -1, 0x000060, 0x001060,       -1, 0x440080, 0x004060,       -1,
+    0x204200,       -1,       -1, 0xC00010, 0x200200, 0x201200, 0x202200,       -1,
+          -1, 0x080108, 0x010060,       -1, 0x208200,       -1,       -1, 0x120002,
+          -1, 0x010440, 0x004011,       -1, 0x002011,       -1, 0x000011, 0x001011,
+    0x00020A,       -1,       -1, 0x880004,       -1, 0x420080, 0x008011,       -1,
+    0x001440, 0x000440,       -1, 0x002440,       -1, 0x004440, 0x010011,       -1,
+          -1, 0x008440, 0x600100,       -1, 0x080820,       -1,       -1, 0x140002,
+    0x800900,       -1,       -1, 0x300008,       -1, 0x408080, 0x020011,       -1,
+          -1, 0x404080, 0x040060,       -1, 0x401080, 0x400080,       -1, 0x402080,
+          -1, 0x020440, 0x080082,       -1, 0x240200,       -1,       -1, 0x000124,
+    0x100014,       -1,       -1, 0x000A01,       -1, 0x410080, 0x800408,       -1,
+    0x600000, 0x601000, 0x602000,       -1, 0x604000,       -1,       -1, 0x800210,
+    0x608000,       -1,       -1, 0x000540,       -1, 0x020024, 0x100088,       -1,
+    0x610000,       -1,       -1, 0x100021,       -1, 0x000848, 0x040404,       -1,
+          -1, 0x040280, 0x820800,       -1, 0x000111,       -1,       -1, 0x280002,
+    0x620000,       -1,       -1, 0x0C0008,       -1, 0x008024, 0x000043,       -1,
+          -1, 0x004024, 0x810800,       -1, 0x001024, 0x000024,       -1, 0x002024,
+          -1, 0x000412, 0x808800,       -1, 0x180200,       -1,       -1, 0x400180,
+    0x802800,       -1, 0x800800, 0x801800,       -1, 0x010024, 0x804800,       -1,
+    0x640000,       -1,       -1, 0x0A0008,       -1, 0x100102, 0x010404,       -1,
+          -1, 0x010280, 0x000032,       -1, 0x880040,       -1,       -1, 0x400801,
+          -1, 0x008280, 0x004404,       -1, 0x002404,       -1, 0x000404, 0x001404,
+    0x001280, 0x000280,       -1, 0x002280,       -1, 0x004280, 0x008404,       -1,
+          -1, 0x082008, 0x081008, 0x080008, 0x000890,       -1,       -1, 0x084008,
+    0x100401,       -1,       -1, 0x088008,       -1, 0x040024, 0x200300,       -1,
+    0x000160,       -1,       -1, 0x090008,       -1, 0xA00001, 0x020404,       -1,
+          -1, 0x020280, 0x840800,       -1, 0x40000A,       -1,       -1, 0x100050,
+    0x680000,       -1,       -1, 0x060008,       -1, 0x000481, 0x000920,       -1,
+          -1, 0x100810, 0x000205,       -1, 0x840040,       -1,       -1, 0x210002,
+          -1, 0x800104, 0x0000D0,       -1, 0x120200,       -1,       -1, 0x208002,
+    0x000428,       -1,       -1, 0x204002,       -1, 0x202002, 0x201002, 0x200002,
+          -1, 0x042008, 0x041008, 0x040008, 0x110200,       -1,       -1, 0x044008,
+    0x000182,       -1,       -1, 0x048008,       -1, 0x080024, 0x400410,       -1,
+    0x104200,       -1,       -1, 0x050008, 0x100200, 0x101200, 0x102200,       -1,
+          -1, 0x400041, 0x880800,       -1, 0x108200,       -1,       -1, 0x220002,
+          -1, 0x022008, 0x021008, 0x020008, 0x808040,       -1,       -1, 0x024008,
+    0x804040,       -1,       -1, 0x028008, 0x800040, 0x801040, 0x802040,       -1,
+    0x000803,       -1,       -1, 0x030008,       -1, 0x400030, 0x080404,       -1,
+          -1, 0x080280, 0x500100,       -1, 0x810040,       -1,       -1, 0x240002,
+    0x003008, 0x002008, 0x001008, 0x000008,       -1, 0x006008, 0x005008, 0x004008,
+          -1, 0x00A008, 0x009008, 0x008008, 0x820040,       -1,       -1, 0x00C008,
+          -1, 0x012008, 0x011008, 0x010008, 0x140200,       -1,       -1, 0x014008,
+    0x200014,       -1,       -1, 0x018008,       -1, 0x000D00, 0x0000A1,       -1,
+    0x700000,       -1,       -1, 0x010021,       -1, 0x040102, 0x008088,       -1,
+          -1, 0x080810, 0x004088,       -1, 0x002088,       -1, 0x000088, 0x001088,
+          -1, 0x002021, 0x001021, 0x000021, 0x0A0200,       -1,       -1, 0x004021,
+    0x000046,       -1,       -1, 0x008021,       -1, 0xC00400, 0x010088,       -1,
+          -1, 0x8000C0, 0x000114,       -1, 0x090200,       -1,       -1, 0x200C00,
+    0x040401,       -1,       -1, 0x400202,       -1, 0x100024, 0x020088,       -1,
+    0x084200,       -1,       -1, 0x020021, 0x080200, 0x081200, 0x082200,       -1,
+          -1, 0x200108, 0x900800,       -1, 0x088200,       -1,       -1, 0x040050,
+          -1, 0x004102, 0x000A40,       -1, 0x001102, 0x000102,       -1, 0x002102,
+    0x020401,       -1,       -1, 0xA00004,       -1, 0x008102, 0x040088,       -1,
+    0x800018,       -1,       -1, 0x040021,       -1, 0x010102, 0x100404,       -1,
+          -1, 0x100280, 0x480100,       -1, 0x200820,       -1,       -1, 0x020050,
+    0x008401,       -1,       -1, 0x180008,       -1, 0x020102, 0xC00020,       -1,
+    0x000401, 0x001401, 0x002401,       -1, 0x004401,       -1,       -1, 0x010050,
+          -1, 0x400804, 0x200082,       -1, 0x0C0200,       -1,       -1, 0x008050,
+    0x010401,       -1,       -1, 0x004050,       -1, 0x002050, 0x001050, 0x000050,
+          -1, 0x008810, 0x800402,       -1, 0x030200,       -1,       -1, 0x400044,
+    0x001810, 0x000810,       -1, 0x002810,       -1, 0x004810, 0x080088,       -1,
+    0x024200,       -1,       -1, 0x080021, 0x020200, 0x021200, 0x022200,       -1,
+          -1, 0x010810, 0x440100,       -1, 0x028200,       -1,       -1, 0x300002,
+    0x014200,       -1,       -1, 0x140008, 0x010200, 0x011200, 0x012200,       -1,
+          -1, 0x020810, 0x200060,       -1, 0x018200,       -1,       -1, 0x800101,
+    0x004200, 0x005200, 0x006200,       -1, 0x000200, 0x001200, 0x002200, 0x003200,
+    0x00C200,       -1,       -1, 0x000484, 0x008200, 0x009200, 0x00A200,       -1,
+    0x0000A4,       -1,       -1, 0x120008,       -1, 0x080102, 0x200011,       -1,
+          -1, 0x040810, 0x410100,       -1, 0x900040,       -1,       -1, 0x000620,
+          -1, 0x200440, 0x408100,       -1, 0x060200,       -1,       -1, 0x800880,
+    0x402100,       -1, 0x400100, 0x401100,       -1, 0x00000D, 0x404100,       -1,
+          -1, 0x102008, 0x101008, 0x100008, 0x050200,       -1,       -1, 0x104008,
+    0x080401,       -1,       -1, 0x108008,       -1, 0x600080, 0x000806,       -1,
+    0x044200,       -1,       -1, 0x110008, 0x040200, 0x041200, 0x042200,       -1,
+          -1, 0x800022, 0x420100,       -1, 0x048200,       -1,       -1, 0x080050,
+    0x800000, 0x801000, 0x802000, 0x803000, 0x804000, 0x805000, 0x806000,       -1,
+    0x808000, 0x809000, 0x80A000,       -1, 0x80C000,       -1,       -1, 0x020048,
+    0x810000, 0x811000, 0x812000,       -1, 0x814000,       -1,       -1, 0x000824,
+    0x818000,       -1,       -1, 0x000301,       -1, 0x300400, 0x040090,       -1,
+    0x820000, 0x821000, 0x822000,       -1, 0x824000,       -1,       -1, 0x008048,
+    0x828000,       -1,       -1, 0x004048,       -1, 0x002048, 0x001048, 0x000048,
+    0x830000,       -1,       -1, 0x180010,       -1, 0x440001, 0x000602,       -1,
+          -1, 0x000086, 0x600800,       -1, 0x080120,       -1,       -1, 0x010048,
+    0x840000, 0x841000, 0x842000,       -1, 0x844000,       -1,       -1, 0x080500,
+    0x848000,       -1,       -1, 0x500004,       -1, 0x000222, 0x010090,       -1,
+    0x850000,       -1,       -1, 0x200042,       -1, 0x420001, 0x008090,       -1,
+          -1, 0x080808, 0x004090,       -1, 0x002090,       -1, 0x000090, 0x001090,
+    0x860000,       -1,       -1, 0x000A80,       -1, 0x410001, 0x300020,       -1,
+          -1, 0x200110, 0x080003,       -1, 0x000C04,       -1,       -1, 0x040048,
+          -1, 0x404001, 0x00010C,       -1, 0x401001, 0x400001,       -1, 0x402001,
+    0x100240,       -1,       -1, 0x800420,       -1, 0x408001, 0x020090,       -1,
+    0x880000, 0x881000, 0x882000,       -1, 0x884000,       -1,       -1, 0x040500,
+    0x888000,       -1,       -1, 0x2000A0,       -1, 0x000015, 0x100A00,       -1,
+    0x890000,       -1,       -1, 0x120010,       -1, 0x0002C0, 0x200009,       -1,
+          -1, 0x040808, 0x000444,       -1, 0x020120,       -1,       -1, 0xC00002,
+    0x8A0000,       -1,       -1, 0x110010,       -1, 0x200802, 0x400084,       -1,
+          -1, 0x400600, 0x040003,       -1, 0x010120,       -1,       -1, 0x080048,
+          -1, 0x102010, 0x101010, 0x100010, 0x008120,       -1,       -1, 0x104010,
+    0x004120,       -1,       -1, 0x108010, 0x000120, 0x001120, 0x002120,       -1,
+    0x8C0000,       -1,       -1, 0x004500,       -1, 0x002500, 0x001500, 0x000500,
+          -1, 0x010808, 0x020003,       -1, 0x600040,       -1,       -1, 0x008500,
+          -1, 0x008808, 0x400220,       -1, 0x100006,       -1,       -1, 0x010500,
+    0x001808, 0x000808,       -1, 0x002808,       -1, 0x004808, 0x080090,       -1,
+          -1, 0x000064, 0x008003,       -1, 0x000218,       -1,       -1, 0x020500,
+    0x002003,       -1, 0x000003, 0x001003,       -1, 0x900080, 0x004003,       -1,
+    0x200480,       -1,       -1, 0x140010,       -1, 0x480001, 0x800840,       -1,
+          -1, 0x020808, 0x010003,       -1, 0x040120,       -1,       -1, 0x200204,
+    0x900000, 0x901000, 0x902000,       -1, 0x904000,       -1,       -1, 0x000083,
+    0x908000,       -1,       -1, 0x440004,       -1, 0x210400, 0x080A00,       -1,
+    0x910000,       -1,       -1, 0x0A0010,       -1, 0x208400, 0x400140,       -1,
+          -1, 0x204400, 0x00002A,       -1, 0x201400, 0x200400,       -1, 0x202400,
+    0x920000,       -1,       -1, 0x090010,       -1, 0x000304, 0x240020,       -1,
+          -1, 0x000821, 0x000580,       -1, 0x400012,       -1,       -1, 0x100048,
+          -1, 0x082010, 0x081010, 0x080010, 0x000888,       -1,       -1, 0x084010,
+    0x040240,       -1,       -1, 0x088010,       -1, 0x220400, 0x800005,       -1,
+    0x940000,       -1,       -1, 0x408004,       -1, 0x000850, 0x220020,       -1,
+          -1, 0x402004, 0x401004, 0x400004, 0x000109,       -1,       -1, 0x404004,
+          -1, 0x0001A0, 0x000C01,       -1, 0x080006,       -1,       -1, 0x800208,
+    0x020240,       -1,       -1, 0x410004,       -1, 0x240400, 0x100090,       -1,
+          -1, 0x00040A, 0x204020,       -1, 0x202020,       -1, 0x200020, 0x201020,
+    0x010240,       -1,       -1, 0x420004,       -1, 0x880080, 0x208020,       -1,
+    0x008240,       -1,       -1, 0x0C0010,       -1, 0x500001, 0x210020,       -1,
+    0x000240, 0x001240, 0x002240,       -1, 0x004240,       -1,       -1, 0x000902,
+    0x980000,       -1,       -1, 0x030010,       -1, 0x400028, 0x008A00,       -1,
+          -1, 0x000142, 0x004A00,       -1, 0x002A00,       -1, 0x000A00, 0x001A00,
+          -1, 0x022010, 0x021010, 0x020010, 0x040006,       -1,       -1, 0x024010,
+    0x400081,       -1,       -1, 0x028010,       -1, 0x280400, 0x010A00,       -1,
+          -1, 0x012010, 0x011010, 0x010010, 0x000441,       -1,       -1, 0x014010,
+    0x20000C,       -1,       -1, 0x018010,       -1, 0x840080, 0x020A00,       -1,
+    0x003010, 0x002010, 0x001010, 0x000010,       -1, 0x006010, 0x005010, 0x004010,
+          -1, 0x00A010, 0x009010, 0x008010, 0x100120,       -1,       -1, 0x00C010,
+          -1, 0x200201, 0x0000C8,       -1, 0x010006,       -1,       -1, 0x100500,
+    0x000430,       -1,       -1, 0x480004,       -1, 0x820080, 0x040A00,       -1,
+    0x004006,       -1,       -1, 0x060010, 0x000006, 0x001006, 0x002006,       -1,
+          -1, 0x100808, 0xA00100,       -1, 0x008006,       -1,       -1, 0x000061,
+    0x400900,       -1,       -1, 0x050010,       -1, 0x808080, 0x280020,       -1,
+          -1, 0x804080, 0x100003,       -1, 0x801080, 0x800080,       -1, 0x802080,
+          -1, 0x042010, 0x041010, 0x040010, 0x020006,       -1,       -1, 0x044010,
+    0x080240,       -1,       -1, 0x048010,       -1, 0x810080, 0x400408,       -1,
+    0xA00000, 0xA01000, 0xA02000,       -1, 0xA04000,       -1,       -1, 0x400210,
+    0xA08000,       -1,       -1, 0x0800A0,       -1, 0x110400, 0x000106,       -1,
+    0xA10000,       -1,       -1, 0x040042,       -1, 0x108400, 0x080009,       -1,
+          -1, 0x104400, 0x420800,       -1, 0x101400, 0x100400,       -1, 0x102400,
+    0xA20000,       -1,       -1, 0x000405,       -1, 0x080802, 0x140020,       -1,
+          -1, 0x040110, 0x410800,       -1, 0x000281,       -1,       -1, 0x200048,
+          -1, 0x000228, 0x408800,       -1, 0x000054,       -1,       -1, 0x800180,
+    0x402800,       -1, 0x400800, 0x401800,       -1, 0x120400, 0x404800,       -1,
+    0xA40000,       -1,       -1, 0x010042,       -1, 0x00008C, 0x120020,       -1,
+          -1, 0x020110, 0x000608,       -1, 0x480040,       -1,       -1, 0x800801,
+          -1, 0x002042, 0x001042, 0x000042, 0x000B00,       -1,       -1, 0x004042,
+    0x000025,       -1,       -1, 0x008042,       -1, 0x140400, 0x200090,       -1,
+          -1, 0x008110, 0x104020,       -1, 0x102020,       -1, 0x100020, 0x101020,
+    0x001110, 0x000110,       -1, 0x002110,       -1, 0x004110, 0x108020,       -1,
+    0x080480,       -1,       -1, 0x020042,       -1, 0x600001, 0x110020,       -1,
+          -1, 0x010110, 0x440800,       -1, 0x80000A,       -1,       -1, 0x080204,
+    0xA80000,       -1,       -1, 0x0080A0,       -1, 0x020802, 0x010009,       -1,
+          -1, 0x0020A0, 0x0010A0, 0x0000A0, 0x440040,       -1,       -1, 0x0040A0,
+          -1, 0x400104, 0x004009,       -1, 0x002009,       -1, 0x000009, 0x001009,
+    0x000212,       -1,       -1, 0x0100A0,       -1, 0x180400, 0x008009,       -1,
+          -1, 0x004802, 0x000340,       -1, 0x001802, 0x000802,       -1, 0x002802,
+    0x10000C,       -1,       -1, 0x0200A0,       -1, 0x008802, 0x800410,       -1,
+    0x040480,       -1,       -1, 0x300010,       -1, 0x010802, 0x020009,       -1,
+          -1, 0x800041, 0x480800,       -1, 0x200120,       -1,       -1, 0x040204,
+          -1, 0x100201, 0x000814,       -1, 0x408040,       -1,       -1, 0x200500,
+    0x404040,       -1,       -1, 0x0400A0, 0x400040, 0x401040, 0x402040,       -1,
+    0x020480,       -1,       -1, 0x080042,       -1, 0x800030, 0x040009,       -1,
+          -1, 0x200808, 0x900100,       -1, 0x410040,       -1,       -1, 0x020204,
+    0x010480,       -1,       -1, 0xC00008,       -1, 0x040802, 0x180020,       -1,
+          -1, 0x080110, 0x200003,       -1, 0x420040,       -1,       -1, 0x010204,
+    0x000480, 0x001480, 0x002480,       -1, 0x004480,       -1,       -1, 0x008204,
+    0x008480,       -1,       -1, 0x004204,       -1, 0x002204, 0x001204, 0x000204,
+    0xB00000,       -1,       -1, 0x000908,       -1, 0x018400, 0x060020,       -1,
+          -1, 0x014400, 0x000051,       -1, 0x011400, 0x010400,       -1, 0x012400,
+          -1, 0x00C400, 0x000284,       -1, 0x009400, 0x008400,       -1, 0x00A400,
+    0x005400, 0x004400,       -1, 0x006400, 0x001400, 0x000400, 0x003400, 0x002400,
+          -1, 0x4000C0, 0x044020,       -1, 0x042020,       -1, 0x040020, 0x041020,
+    0x08000C,       -1,       -1, 0x800202,       -1, 0x030400, 0x048020,       -1,
+    0x000103,       -1,       -1, 0x280010,       -1, 0x028400, 0x050020,       -1,
+          -1, 0x024400, 0x500800,       -1, 0x021400, 0x020400,       -1, 0x022400,
+          -1, 0x080201, 0x024020,       -1, 0x022020,       -1, 0x020020, 0x021020,
+    0x000882,       -1,       -1, 0x600004,       -1, 0x050400, 0x028020,       -1,
+    0x400018,       -1,       -1, 0x100042,       -1, 0x048400, 0x030020,       -1,
+          -1, 0x044400, 0x880100,       -1, 0x041400, 0x040400,       -1, 0x042400,
+    0x006020,       -1, 0x004020, 0x005020, 0x002020, 0x003020, 0x000020, 0x001020,
+          -1, 0x100110, 0x00C020,       -1, 0x00A020,       -1, 0x008020, 0x009020,
+          -1, 0x800804, 0x014020,       -1, 0x012020,       -1, 0x010020, 0x011020,
+    0x200240,       -1,       -1, 0x000089,       -1, 0x060400, 0x018020,       -1,
+          -1, 0x040201, 0x400402,       -1, 0x000190,       -1,       -1, 0x800044,
+    0x02000C,       -1,       -1, 0x1000A0,       -1, 0x090400, 0x200A00,       -1,
+    0x000860,       -1,       -1, 0x220010,       -1, 0x088400, 0x100009,       -1,
+          -1, 0x084400, 0x840100,       -1, 0x081400, 0x080400,       -1, 0x082400,
+    0x00800C,       -1,       -1, 0x210010,       -1, 0x100802, 0x0C0020,       -1,
+    0x00000C, 0x00100C, 0x00200C,       -1, 0x00400C,       -1,       -1, 0x400101,
+          -1, 0x202010, 0x201010, 0x200010, 0xC00200,       -1,       -1, 0x204010,
+    0x01000C,       -1,       -1, 0x208010,       -1, 0x0A0400, 0x0000C2,       -1,
+    0x001201, 0x000201,       -1, 0x002201,       -1, 0x004201, 0x0A0020,       -1,
+          -1, 0x008201, 0x810100,       -1, 0x500040,       -1,       -1, 0x00001A,
+          -1, 0x010201, 0x808100,       -1, 0x200006,       -1,       -1, 0x400880,
+    0x802100,       -1, 0x800100, 0x801100,       -1, 0x0C0400, 0x804100,       -1,
+          -1, 0x020201, 0x084020,       -1, 0x082020,       -1, 0x080020, 0x081020,
+    0x04000C,       -1,       -1, 0x000C40,       -1, 0xA00080, 0x088020,       -1,
+    0x100480,       -1,       -1, 0x240010,       -1, 0x000148, 0x090020,       -1,
+          -1, 0x400022, 0x820100,       -1, 0x000811,       -1,       -1, 0x100204,
+    0xC00000, 0xC01000, 0xC02000,       -1, 0xC04000,       -1,       -1, 0x200210,
+    0xC08000,       -1,       -1, 0x140004,       -1, 0x000980, 0x000421,       -1,
+    0xC10000,       -1,       -1, 0x000488,       -1, 0x060001, 0x100140,       -1,
+          -1, 0x000070, 0x220800,       -1, 0x00020C,       -1,       -1, 0x880002,
+    0xC20000,       -1,       -1, 0x000122,       -1, 0x050001, 0x080084,       -1,
+          -1, 0x080600, 0x210800,       -1, 0x100012,       -1,       -1, 0x400048,
+          -1, 0x044001, 0x208800,       -1, 0x041001, 0x040001,       -1, 0x042001,
+    0x202800,       -1, 0x200800, 0x201800,       -1, 0x048001, 0x204800,       -1,
+    0xC40000,       -1,       -1, 0x108004,       -1, 0x030001, 0x00080A,       -1,
+          -1, 0x102004, 0x101004, 0x100004, 0x280040,       -1,       -1, 0x104004,
+          -1, 0x024001, 0x080220,       -1, 0x021001, 0x020001,       -1, 0x022001,
+    0x000502,       -1,       -1, 0x110004,       -1, 0x028001, 0x400090,       -1,
+          -1, 0x014001, 0x000450,       -1, 0x011001, 0x010001,       -1, 0x012001,
+    0x0000A8,       -1,       -1, 0x120004,       -1, 0x018001, 0x800300,       -1,
+    0x005001, 0x004001,       -1, 0x006001, 0x001001, 0x000001, 0x003001, 0x002001,
+          -1, 0x00C001, 0x240800,       -1, 0x009001, 0x008001,       -1, 0x00A001,
+    0xC80000,       -1,       -1, 0x000841,       -1, 0x100028, 0x020084,       -1,
+          -1, 0x020600, 0x000118,       -1, 0x240040,       -1,       -1, 0x810002,
+          -1, 0x200104, 0x040220,       -1, 0x000C10,       -1,       -1, 0x808002,
+    0x100081,       -1,       -1, 0x804002,       -1, 0x802002, 0x801002, 0x800002,
+          -1, 0x008600, 0x004084,       -1, 0x002084,       -1, 0x000084, 0x001084,
+    0x001600, 0x000600,       -1, 0x002600,       -1, 0x004600, 0x008084,       -1,
+    0x00004A,       -1,       -1, 0x500010,       -1, 0x0C0001, 0x010084,       -1,
+          -1, 0x010600, 0x280800,       -1, 0x400120,       -1,       -1, 0x820002,
+          -1, 0x000092, 0x010220,       -1, 0x208040,       -1,       -1, 0x400500,
+    0x204040,       -1,       -1, 0x180004, 0x200040, 0x201040, 0x202040,       -1,
+    0x002220,       -1, 0x000220, 0x001220,       -1, 0x0A0001, 0x004220,       -1,
+          -1, 0x400808, 0x008220,       -1, 0x210040,       -1,       -1, 0x840002,
+    0x100900,       -1,       -1, 0xA00008,       -1, 0x090001, 0x040084,       -1,
+          -1, 0x040600, 0x400003,       -1, 0x220040,       -1,       -1, 0x000830,
+          -1, 0x084001, 0x020220,       -1, 0x081001, 0x080001,       -1, 0x082001,
+    0x800014,       -1,       -1, 0x0001C0,       -1, 0x088001, 0x100408,       -1,
+    0xD00000,       -1,       -1, 0x048004,       -1, 0x080028, 0x010140,       -1,
+          -1, 0x042004, 0x041004, 0x040004, 0x020012,       -1,       -1, 0x044004,
+          -1, 0x000A02, 0x004140,       -1, 0x002140,       -1, 0x000140, 0x001140,
+    0x080081,       -1,       -1, 0x050004,       -1, 0x600400, 0x008140,       -1,
+          -1, 0x2000C0, 0x000209,       -1, 0x008012,       -1,       -1, 0x800C00,
+    0x004012,       -1,       -1, 0x060004, 0x000012, 0x001012, 0x002012,       -1,
+    0x000424,       -1,       -1, 0x480010,       -1, 0x140001, 0x020140,       -1,
+          -1, 0x800108, 0x300800,       -1, 0x010012,       -1,       -1, 0x0002A0,
+          -1, 0x00A004, 0x009004, 0x008004, 0x000680,       -1,       -1, 0x00C004,
+    0x003004, 0x002004, 0x001004, 0x000004,       -1, 0x006004, 0x005004, 0x004004,
+    0x200018,       -1,       -1, 0x018004,       -1, 0x120001, 0x040140,       -1,
+          -1, 0x012004, 0x011004, 0x010004, 0x800820,       -1,       -1, 0x014004,
+    0x080900,       -1,       -1, 0x028004,       -1, 0x110001, 0x600020,       -1,
+          -1, 0x022004, 0x021004, 0x020004, 0x040012,       -1,       -1, 0x024004,
+          -1, 0x104001, 0x800082,       -1, 0x101001, 0x100001,       -1, 0x102001,
+    0x400240,       -1,       -1, 0x030004,       -1, 0x108001, 0x080408,       -1,
+          -1, 0x004028, 0x200402,       -1, 0x001028, 0x000028,       -1, 0x002028,
+    0x010081,       -1,       -1, 0x0C0004,       -1, 0x008028, 0x400A00,       -1,
+    0x008081,       -1,       -1, 0x420010,       -1, 0x010028, 0x080140,       -1,
+    0x000081, 0x001081, 0x002081,       -1, 0x004081,       -1,       -1, 0x900002,
+    0x040900,       -1,       -1, 0x410010,       -1, 0x020028, 0x100084,       -1,
+          -1, 0x100600, 0x800060,       -1, 0x080012,       -1,       -1, 0x200101,
+          -1, 0x402010, 0x401010, 0x400010, 0xA00200,       -1,       -1, 0x404010,
+    0x020081,       -1,       -1, 0x408010,       -1, 0x000844, 0x040408,       -1,
+    0x020900,       -1,       -1, 0x088004,       -1, 0x040028, 0x800011,       -1,
+          -1, 0x082004, 0x081004, 0x080004, 0x300040,       -1,       -1, 0x084004,
+          -1, 0x800440, 0x100220,       -1, 0x400006,       -1,       -1, 0x200880,
+    0x040081,       -1,       -1, 0x090004,       -1, 0x000310, 0x020408,       -1,
+    0x000900, 0x001900, 0x002900,       -1, 0x004900,       -1,       -1, 0x000242,
+    0x008900,       -1,       -1, 0x0A0004,       -1, 0xC00080, 0x010408,       -1,
+    0x010900,       -1,       -1, 0x440010,       -1, 0x180001, 0x008408,       -1,
+          -1, 0x200022, 0x004408,       -1, 0x002408,       -1, 0x000408, 0x001408,
+    0xE00000,       -1,       -1, 0x004210,       -1, 0x002210, 0x001210, 0x000210,
+          -1, 0x00000B, 0x030800,       -1, 0x0C0040,       -1,       -1, 0x008210,
+          -1, 0x080104, 0x028800,       -1, 0x0000A2,       -1,       -1, 0x010210,
+    0x022800,       -1, 0x020800, 0x021800,       -1, 0x500400, 0x024800,       -1,
+          -1, 0x1000C0, 0x018800,       -1, 0x000508,       -1,       -1, 0x020210,
+    0x012800,       -1, 0x010800, 0x011800,       -1, 0x800024, 0x014800,       -1,
+    0x00A800,       -1, 0x008800, 0x009800,       -1, 0x240001, 0x00C800,       -1,
+    0x002800, 0x003800, 0x000800, 0x001800, 0x006800,       -1, 0x004800, 0x005800,
+          -1, 0x000C20, 0x000181,       -1, 0x088040,       -1,       -1, 0x040210,
+    0x084040,       -1,       -1, 0x300004, 0x080040, 0x081040, 0x082040,       -1,
+    0x100018,       -1,       -1, 0x400042,       -1, 0x220001, 0x800404,       -1,
+          -1, 0x800280, 0x060800,       -1, 0x090040,       -1,       -1, 0x000128,
+    0x000206,       -1,       -1, 0x880008,       -1, 0x210001, 0x500020,       -1,
+          -1, 0x400110, 0x050800,       -1, 0x0A0040,       -1,       -1, 0x000482,
+          -1, 0x204001, 0x048800,       -1, 0x201001, 0x200001,       -1, 0x202001,
+    0x042800,       -1, 0x040800, 0x041800,       -1, 0x208001, 0x044800,       -1,
+          -1, 0x010104, 0x100402,       -1, 0x048040,       -1,       -1, 0x080210,
+    0x044040,       -1,       -1, 0x4000A0, 0x040040, 0x041040, 0x042040,       -1,
+    0x001104, 0x000104,       -1, 0x002104,       -1, 0x004104, 0x400009,       -1,
+          -1, 0x008104, 0x0A0800,       -1, 0x050040,       -1,       -1, 0xA00002,
+    0x000031,       -1,       -1, 0x840008,       -1, 0x400802, 0x200084,       -1,
+          -1, 0x200600, 0x090800,       -1, 0x060040,       -1,       -1, 0x100101,
+          -1, 0x020104, 0x088800,       -1, 0x900200,       -1,       -1, 0x000460,
+    0x082800,       -1, 0x080800, 0x081800,       -1, 0x000098, 0x084800,       -1,
+    0x00C040,       -1,       -1, 0x820008, 0x008040, 0x009040, 0x00A040,       -1,
+    0x004040, 0x005040, 0x006040,       -1, 0x000040, 0x001040, 0x002040, 0x003040,
+          -1, 0x040104, 0x200220,       -1, 0x018040,       -1,       -1, 0x100880,
+    0x014040,       -1,       -1, 0x000411, 0x010040, 0x011040, 0x012040,       -1,
+          -1, 0x802008, 0x801008, 0x800008, 0x028040,       -1,       -1, 0x804008,
+    0x024040,       -1,       -1, 0x808008, 0x020040, 0x021040, 0x022040,       -1,
+    0x400480,       -1,       -1, 0x810008,       -1, 0x280001, 0x000112,       -1,
+          -1, 0x100022, 0x0C0800,       -1, 0x030040,       -1,       -1, 0x400204,
+          -1, 0x0200C0, 0x080402,       -1, 0x000805,       -1,       -1, 0x100210,
+    0x000320,       -1,       -1, 0x240004,       -1, 0x410400, 0x800088,       -1,
+    0x040018,       -1,       -1, 0x800021,       -1, 0x408400, 0x200140,       -1,
+          -1, 0x404400, 0x120800,       -1, 0x401400, 0x400400,       -1, 0x402400,
+    0x0010C0, 0x0000C0,       -1, 0x0020C0,       -1, 0x0040C0, 0x440020,       -1,
+          -1, 0x0080C0, 0x110800,       -1, 0x200012,       -1,       -1, 0x080101,
+          -1, 0x0100C0, 0x108800,       -1, 0x880200,       -1,       -1, 0x00000E,
+    0x102800,       -1, 0x100800, 0x101800,       -1, 0x420400, 0x104800,       -1,
+    0x010018,       -1,       -1, 0x208004,       -1, 0x800102, 0x420020,       -1,
+          -1, 0x202004, 0x201004, 0x200004, 0x180040,       -1,       -1, 0x204004,
+    0x000018, 0x001018, 0x002018,       -1, 0x004018,       -1,       -1, 0x080880,
+    0x008018,       -1,       -1, 0x210004,       -1, 0x440400, 0x000203,       -1,
+          -1, 0x0400C0, 0x404020,       -1, 0x402020,       -1, 0x400020, 0x401020,
+    0x800401,       -1,       -1, 0x220004,       -1, 0x000A08, 0x408020,       -1,
+    0x020018,       -1,       -1, 0x000700,       -1, 0x300001, 0x410020,       -1,
+          -1, 0x080022, 0x140800,       -1, 0x000184,       -1,       -1, 0x800050,
+    0x002402,       -1, 0x000402, 0x001402,       -1, 0x200028, 0x004402,       -1,
+          -1, 0x800810, 0x008402,       -1, 0x140040,       -1,       -1, 0x020101,
+          -1, 0x100104, 0x010402,       -1, 0x820200,       -1,       -1, 0x040880,
+    0x200081,       -1,       -1, 0x000248,       -1, 0x480400, 0x000034,       -1,
+          -1, 0x0800C0, 0x020402,       -1, 0x810200,       -1,       -1, 0x008101,
+    0x40000C,       -1,       -1, 0x004101,       -1, 0x002101, 0x001101, 0x000101,
+    0x804200,       -1,       -1, 0x600010, 0x800200, 0x801200, 0x802200,       -1,
+          -1, 0x040022, 0x180800,       -1, 0x808200,       -1,       -1, 0x010101,
+          -1, 0x400201, 0x040402,       -1, 0x108040,       -1,       -1, 0x010880,
+    0x104040,       -1,       -1, 0x280004, 0x100040, 0x101040, 0x102040,       -1,
+    0x080018,       -1,       -1, 0x004880,       -1, 0x002880, 0x001880, 0x000880,
+          -1, 0x020022, 0xC00100,       -1, 0x110040,       -1,       -1, 0x008880,
+    0x200900,       -1,       -1, 0x900008,       -1, 0x000414, 0x480020,       -1,
+          -1, 0x010022, 0x000290,       -1, 0x120040,       -1,       -1, 0x040101,
+          -1, 0x008022, 0x000045,       -1, 0x840200,       -1,       -1, 0x020880,
+    0x001022, 0x000022,       -1, 0x002022,       -1, 0x004022, 0x200408,       -1,
+};
 
-/* Function to compute the Hamming weight of a 12-bit integer */
-static guint weight12(guint vector)
-{
-    guint w=0;
-    guint i;
-    for( i=0; i<12; i++ )
-	if( vector & 1<<i )
-	    w++;
-    return w;
-}
 
 /* returns the golay coding of the given 12-bit word */
 static guint golay_coding(guint w)
 {
-    guint out=0;
-    guint i;
-
-    for( i = 0; i<12; i++ ) {
-	if( w & 1<<i )
-	    out ^= golay_encode_matrix[i];
-    }
-    return out;
+    return golay_encode_low[w & 0x3f] ^ golay_encode_high[(w>>6) & 0x3f];
 }
 
 /* encodes a 12-bit word to a 24-bit codeword */
@@ -122,21 +636,6 @@ guint32 golay_encode(guint w)
 }
 
 
-
-/* returns the golay coding of the given 12-bit word */
-static guint golay_decoding(guint w)
-{
-    guint out=0;
-    guint i;
-
-    for( i = 0; i<12; i++ ) {
-	if( w & 1<<(i) )
-	    out ^= golay_decode_matrix[i];
-    }
-    return out;
-}
-
-
 /* return a mask showing the bits which are in error in a received
  * 24-bit codeword, or -1 if 4 errors were detected.
  */
@@ -144,101 +643,20 @@ gint32 golay_errors(guint32 codeword)
 {
     guint received_data, received_parity;
     guint syndrome;
-    guint w,i;
-    guint inv_syndrome = 0;
 
-    received_parity = (guint)(codeword>>12);
+    received_parity = (guint)(codeword>>12) & 0xfff;
     received_data   = (guint)codeword & 0xfff;
 
-    /* We use the C notation ^ for XOR to represent addition modulo 2.
-     *
-     * Model the received codeword (r) as the transmitted codeword (u)
-     * plus an error vector (e).
-     *
-     *   r = e ^ u
-     *
-     * Then we calculate a syndrome (s):
-     *
-     *   s = r * H, where H = [ P   ], where I12 is the identity matrix
-     *                        [ I12 ]
-     *
-     * (In other words, we calculate the parity check for the received
-     * data bits, and add them to the received parity bits)
+    /* The syndrome is the parity check for the received data bits added
+     * to the received parity bits, s = r * H
      */
-
     syndrome = received_parity ^ (golay_coding(received_data));
-    w = weight12(syndrome);
-    
-    /*
-     * The properties of the golay code are such that the Hamming distance (ie,
-     * the minimum distance between codewords) is 8; that means that one bit of
-     * error in the data bits will cause 7 errors in the parity bits.
-     *
-     * In particular, if we find 3 or fewer errors in the parity bits, either:
-     *  - there are no errors in the data bits, or
-     *  - there are at least 5 errors in the data bits
-     * we hope for the former (we don't profess to deal with the
-     * latter).
-     */
-    if( w <= 3 ) {
-	return ((gint32) syndrome)<<12;
-    }
-    
-    /* the next thing to try is one error in the data bits.
-     * we try each bit in turn and see if an error in that bit would have given
-     * us anything like the parity bits we got. At this point, we tolerate two
-     * errors in the parity bits, but three or more errors would give a total
-     * error weight of 4 or more, which means it's actually uncorrectable or
-     * closer to another codeword. */
-     
-    for( i = 0; i<12; i++ ) {
-	guint error = 1<<i;
-	guint coding_error = golay_encode_matrix[i];
-	if( weight12(syndrome^coding_error) <= 2 ) {
-	    return (gint32)((((guint32)(syndrome^coding_error))<<12) | (guint32)error) ;
-	}
-    }
-
-    /* okay then, let's see whether the parity bits are error free, and all the
-     * errors are in the data bits. model this as follows:
-     *
-     * [r | pr] = [u | pu] + [e | 0]
-     *
-     * pr = pu
-     * pu = H * u => u = H' * pu = H' * pr , where H' is inverse of H
-     *
-     * we already have s = H*r + pr, so pr = s - H*r = s ^ H*r
-     * e = u ^ r
-     *   = (H' * ( s ^ H*r )) ^ r
-     *   = H'*s ^ r ^ r
-     *   = H'*s
-     *
-     * Once again, we accept up to three error bits...
-     */
 
-    inv_syndrome = golay_decoding(syndrome);
-    w = weight12(inv_syndrome);
-    if( w <=3 ) {
-	return (gint32)inv_syndrome;
-    }
-
-    /* Final shot: try with 2 errors in the data bits, and 1 in the parity
-     * bits; as before we try each of the bits in the parity in turn */
-    for( i = 0; i<12; i++ ) {
-	guint error = 1<<i;
-	guint coding_error = golay_decode_matrix[i];
-	if( weight12(inv_syndrome^coding_error) <= 2 ) {
-	    guint32 error_word = ((guint32)(inv_syndrome^coding_error)) | ((guint32)error)<<12;
-	    return (gint32)error_word;
-	}
-    }
-
-    /* uncorrectable error */
-    return -1;
+    /* Look up the error pattern */
+    return golay_errors_table[syndrome];
 }
     
 
-
 /* decode a received codeword. Up to 3 errors are corrected for; 4
    errors are detected as uncorrectable (return -1); 5 or more errors
    cause an incorrect correction.
@@ -19,33 +19,31 @@
  ***************************************************************************/
 #include "jitterBuffer.h"
 
-jitterBuffer::jitterBuffer(int pack, int delay)
+jitterBuffer::jitterBuffer(int pack, int delay, int cap)
 {
 	//Initialize ticks
 	ticks	= 0;
 	nextPacket = 0;
-	//Initialize list
+	//Initialize ring
 	size	= 0;
-	buffer	= 0;
-	last	= 0;
+	head	= 0;
+	capacity = cap;
+	buffer	= (struct env *)malloc(sizeof(struct env)*capacity);
+	//Initialize counters
+	overflow = e_DropOldest;
+	discard = false;
+	dropped = 0;
+	maxSize = 0;
 	//Set jitter parameters
 	SetBuffer(pack,delay);
 }
 
 jitterBuffer::~ jitterBuffer()
 {
-	//Empty queue
-	while(size)
-	{
-		//Get next
-		struct env *tmp = buffer;
-		//Move to the next
-		buffer = buffer->next;
-		//Delete element
-		free(tmp);
-		//Descrease size
-		size--;
-	}
+	//Release queued sdus
+	Clear();
+	//Free ring
+	free(buffer);
 }
 
 void jitterBuffer::Tick( DWORD len )
@@ -54,36 +52,89 @@ void jitterBuffer::Tick( DWORD len )
 	ticks += len;
 }
 
-void jitterBuffer::Push( H223MuxSDU *sdu )
+void jitterBuffer::Push( H223MuxSDU *sdu, int reference, int start )
 {
-	//Create a new Envelop
-	struct env *newEl = (struct env *)malloc(sizeof(struct env));
+	//A new frame ends the discarding of the last one
+	if (start)
+		discard = false;
 
-	//Inizialize element
-	newEl->sdu = sdu;
-	newEl->next = 0;
+	//If it's full make room, if the rest of this frame was dropped drop this one too
+	if (!discard && size==capacity && Drop() && !start)
+		discard = true;
 
-	//Insert in the list
-	if(!size)
+	//If the begining of its frame was dropped
+	if (discard)
 	{
-		//The first element
-		buffer = newEl;
-		last = newEl;
-	} else {
-		//Append to the last one
-		last->next = newEl;
-		last = last->next;
+		//Release it
+		sdu->Release();
+		//One more dropped
+		dropped++;
+		//Exit
+		return;
 	}
 
+	//Get the position after the last one
+	struct env *el = &buffer[(head+size)%capacity];
+
+	//Inizialize element
+	el->sdu = sdu;
+	el->reference = reference;
+	el->start = start;
+
 	//Increase size;
 	size++;
 
+	//Update occupancy
+	if (size>maxSize)
+		maxSize = size;
+
 	//Check if there are the minimum packets in the queue
 	if(wait && size>=minPackets)
 		//No more waiting
 		wait = false;
 }
 
+int jitterBuffer::Drop()
+{
+	int i = 0;
+
+	//If we prefer to drop non reference frames
+	if (overflow==e_DropNonReference)
+		//Find the start of the oldest one
+		while (i<size && (buffer[(head+i)%capacity].reference || !buffer[(head+i)%capacity].start))
+			i++;
+
+	//If all are references
+	if (i==size)
+		//Drop the oldest frame, or what is left of it
+		i = 0;
+
+	//Get the number of sdus of the frame
+	int n = 1;
+	while (i+n<size && !buffer[(head+i+n)%capacity].start)
+		n++;
+
+	//Check if it was the last one, its next sdus could be still coming
+	int last = (i+n==size);
+
+	//Release them
+	for (int j=0;j<n;j++)
+		buffer[(head+i+j)%capacity].sdu->Release();
+
+	//Move the older ones n positions up to fill the hole
+	for (i--;i>=0;i--)
+		buffer[(head+i+n)%capacity] = buffer[(head+i)%capacity];
+
+	//Remove first ones
+	head = (head+n)%capacity;
+	size -= n;
+
+	//n more dropped
+	dropped += n;
+
+	return last;
+}
+
 H223MuxSDU *jitterBuffer::GetSDU()
 {
 	//If buffer is locked wait for minPackets size
@@ -102,17 +153,11 @@ H223MuxSDU *jitterBuffer::GetSDU()
 		return 0;
 
 	//Get sdu
-	H223MuxSDU *sdu = buffer->sdu;
+	H223MuxSDU *sdu = buffer[head].sdu;
 	
-	//Pop front list
-	struct env *tmp = buffer;
-
 	//Move to the next
-	buffer = buffer->next;
+	head = (head+1)%capacity;
 
-	//Delete element
-	free(tmp);
- 
 	//Descrease size
 	size--;
 
@@ -137,12 +182,52 @@ H223MuxSDU *jitterBuffer::GetSDU()
 	return sdu;
 }
 
+void jitterBuffer::Clear()
+{
+	//Release all queued sdus
+	while(size)
+	{
+		//Release first
+		buffer[head].sdu->Release();
+		//Move to the next
+		head = (head+1)%capacity;
+		//Descrease size
+		size--;
+	}
+
+	//Start again
+	head = 0;
+	nextPacket = 0;
+	discard = false;
+
+	//Wait for the minimum packets
+	wait = (minPackets>0);
+}
+
 int jitterBuffer::GetSize()
 {
 	//Return number of packets in jitter
 	return size;
 }
 
+int jitterBuffer::GetCapacity()
+{
+	//Return max number of packets in jitter
+	return capacity;
+}
+
+DWORD jitterBuffer::GetDropped()
+{
+	//Return number of packets dropped on overflow
+	return dropped;
+}
+
+int jitterBuffer::GetMaxSize()
+{
+	//Return max number of packets queued at the same time
+	return maxSize;
+}
+
 void jitterBuffer::SetBuffer(int packets,int delay )
 {
 	//Set minimun delay and minimun packets in jitter
@@ -152,3 +237,36 @@ void jitterBuffer::SetBuffer(int packets,int delay )
 	wait = (minPackets>size);
 }
 
+void jitterBuffer::SetCapacity(int cap)
+{
+	//Check it's valid
+	if (cap<1)
+		return;
+
+	//Drop the ones that would not fit
+	while (size>cap)
+		if (Drop())
+			//And the rest of the last frame
+			discard = true;
+
+	//Allocate new ring
+	struct env *ring = (struct env *)malloc(sizeof(struct env)*cap);
+
+	//Copy queued ones in order
+	for (int i=0;i<size;i++)
+		ring[i] = buffer[(head+i)%capacity];
+
+	//Free old one
+	free(buffer);
+
+	//Set new ring
+	buffer = ring;
+	capacity = cap;
+	head = 0;
+}
+
+void jitterBuffer::SetOverflow(Overflow policy)
+{
+	//Set what to drop when full
+	overflow = policy;
+}
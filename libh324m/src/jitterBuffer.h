@@ -23,21 +23,41 @@
 #include "H223MuxSDU.h"
 
 class jitterBuffer {
+public:
+	//What to do when pushing into a full buffer, the sdus of a frame are dropped together
+	enum Overflow {
+		e_DropOldest = 0,
+		e_DropNonReference = 1
+	};
+
 public:
 	//Construtors
-	jitterBuffer(int minPackets, int minDelay);
+	jitterBuffer(int minPackets, int minDelay, int capacity = 64);
 	~jitterBuffer();
 
 	void SetBuffer(int minPackets, int minDelay);
+	void SetCapacity(int capacity);
+	void SetOverflow(Overflow policy);
 	void Tick(DWORD len);
-	void Push(H223MuxSDU *sdu);
+	//Start is false for the rest of the sdus of the same frame, they are dropped with it
+	void Push(H223MuxSDU *sdu, int reference = true, int start = true);
 	H223MuxSDU *GetSDU();
+	void Clear();
 	int GetSize();
 
+	//Counters
+	int GetCapacity();
+	DWORD GetDropped();
+	int GetMaxSize();
+
+private:
+	int Drop();
+
 private:
 	struct env {
 		H223MuxSDU *sdu;
-		struct env *next;
+		int reference;
+		int start;
 	};
 
 	int minPackets;
@@ -46,9 +66,13 @@ private:
 	DWORD ticks;
 	DWORD nextPacket;
 	struct env *buffer;
-	struct env *last;
+	int capacity;
+	int head;
 	int size;
+	Overflow overflow;
+	int discard;
+	DWORD dropped;
+	int maxSize;
 };
 
 #endif
-
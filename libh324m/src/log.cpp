@@ -2,29 +2,52 @@
 #include <stdio.h>
 #include "log.h"
 
-int Logger::level = 0;
+volatile int Logger::level = 0;
+__thread Logger::Context* Logger::current = NULL;
 
-static int (*h324m_logger_callback)  (const char *, va_list) = vprintf;
+static Logger::Callback volatile h324m_logger_callback = vprintf;
 
 void Logger::SetLevel(int level)
 {
+	//Publish it to the other threads
+	__sync_synchronize();
 	Logger::level = level;
 }
 
-void Logger::SetCallback(int (*callback)  (const char *, va_list))
+void Logger::SetCallback(Callback callback)
 {
+	//Back to the default one if none
+	if (!callback)
+		callback = vprintf;
+	//Publish it to the other threads
+	__sync_synchronize();
 	h324m_logger_callback = callback;
 }
 
+void Logger::InitContext(Context *context)
+{
+	//Get the defaults
+	context->level = level;
+	context->callback = h324m_logger_callback;
+}
+
+void Logger::Output(const char* msg,va_list ap)
+{
+	//Get the callback of the current context or the default one
+	Callback callback = current ? current->callback : h324m_logger_callback;
+	//Call it
+	callback(msg,ap);
+}
+
 void Logger::Debug(const char* msg,...)
 {
-	if(level>=4)
+	if(GetLevel()>=4)
 	{
 		va_list ap;
 		//Set list
 		va_start(ap,msg);
 		//Output
-		h324m_logger_callback(msg,ap);
+		Output(msg,ap);
 		//End list
 		va_end(ap);
 	}
@@ -32,13 +55,13 @@ void Logger::Debug(const char* msg,...)
 
 void Logger::Warning(const char* msg,...)
 {
-	if(level>=3)
+	if(GetLevel()>=3)
 	{
 		va_list ap;
 		//Set list
 		va_start(ap,msg);
 		//Output
-		h324m_logger_callback(msg,ap);
+		Output(msg,ap);
 		//End list
 		va_end(ap);
 	}
@@ -46,13 +69,13 @@ void Logger::Warning(const char* msg,...)
 
 void Logger::Log(const char* msg,...)
 {
-	if(level>=2)
+	if(GetLevel()>=2)
 	{
 		va_list ap;
 		//Set list
 		va_start(ap,msg);
 		//Output
-		h324m_logger_callback(msg,ap);
+		Output(msg,ap);
 		//End list
 		va_end(ap);
 	}
@@ -60,13 +83,13 @@ void Logger::Log(const char* msg,...)
 
 void Logger::Error(const char* msg,...)
 {
-	if(level>=1)
+	if(GetLevel()>=1)
 	{
 		va_list ap;
 		//Set list
 		va_start(ap,msg);
 		//Output
-		h324m_logger_callback(msg,ap);
+		Output(msg,ap);
 		//End list
 		va_end(ap);
 	}
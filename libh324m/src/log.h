@@ -1,10 +1,50 @@
 #ifndef _LOG_H_
 #define _LOG_H_
 
+#include <stdarg.h>
 #include "H324MConfig.h"
 
+//Build with -DH324M_NOTRACE to remove the wire tracing calls from the
+//mux, demux and adaptation layers, otherwise they are only made when the
+//logger is tracing (log level 5 or tracing enabled for the session)
+#ifdef H324M_NOTRACE
+#define TRACING(logger)		0
+#define TRACE(logger,call)	do {} while(0)
+#else
+#define TRACING(logger)		((logger)->IsTracing())
+#define TRACE(logger,call)	do { if (TRACING(logger)) (logger)->call; } while(0)
+#endif
+
+/**********************************
+* Logger
+*	The level and callback are kept in a Context owned by each session,
+*	copied from the defaults when it's created. While a session is called
+*	it makes its context the current one of the thread with a Scope, so
+*	the static log calls use the level and callback of that session.
+*	Outside of any session the defaults are used. The callback must be
+*	reentrant as it can be called from every thread driving a session.
+***********************************/
 class Logger
 {
+public:
+	typedef int (*Callback) (const char *, va_list);
+
+	struct Context
+	{
+		int		level;
+		Callback	callback;
+	};
+
+	//Makes a context the current one of the thread until it's destroyed
+	class Scope
+	{
+	public:
+		Scope(Context *context)	{ prev = current; current = context; }
+		~Scope()		{ current = prev; }
+	private:
+		Context *prev;
+	};
+
 public:
 	virtual void SetMuxByte(BYTE b) = 0;
 	virtual void SetMuxInfo(const char*info,...) = 0;
@@ -14,16 +54,26 @@ public:
 	virtual void DumpMediaOutput(BYTE *data,DWORD len)=0;
 	virtual void DumpInput(BYTE *data,DWORD len)=0;
 	virtual void DumpOutput(BYTE *data,DWORD len)=0;
+	virtual void DumpH245Input(const char *text,DWORD len)=0;
+	virtual void DumpH245Output(const char *text,DWORD len)=0;
+	virtual void SetH245Event(const char *info,...)=0;
 	virtual ~Logger() {}
 
 	static void Debug(const char* msg,...);
 	static void Warning(const char* msg,...);
 	static void Log(const char* msg,...);
 	static void Error(const char* msg,...);
+	//Level of the current context
+	static int  GetLevel()	{ return current ? current->level : level; }
+	//Defaults for new contexts and for logging outside of any session
 	static void SetLevel(int level);
-	static void SetCallback(int (*callback)  (const char *, va_list));
-protected:
-	static int level;
+	static void SetCallback(Callback callback);
+	static void InitContext(Context *context);
+private:
+	static void Output(const char* msg,va_list ap);
+private:
+	static volatile int level;
+	static __thread Context *current;
 };
 
 #endif
@@ -0,0 +1,144 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include "../crc8.h"
+#include "../crc16.h"
+
+//Bit by bit reference of the AL2 crc8, x^8+x^2+x+1 reflected
+static BYTE crc8_reference(BYTE *buffer,int len)
+{
+	BYTE crc = 0;
+	for (int i=0;i<len;i++)
+	{
+		crc ^= buffer[i];
+		for (int j=0;j<8;j++)
+			crc = (crc & 1) ? (crc >> 1) ^ 0xE0 : crc >> 1;
+	}
+	return crc;
+}
+
+//Bit by bit reference of the CCSRL crc16, x^16+x^12+x^5+1 reflected
+static WORD crc16_reference(BYTE *buffer,int len)
+{
+	WORD crc = 0xFFFF;
+	for (int i=0;i<len;i++)
+	{
+		crc ^= buffer[i];
+		for (int j=0;j<8;j++)
+			crc = (crc & 1) ? (crc >> 1) ^ 0x8408 : crc >> 1;
+	}
+	return crc ^ 0xFFFF;
+}
+
+static double now()
+{
+	struct timeval tv;
+	gettimeofday(&tv,NULL);
+	return tv.tv_sec + tv.tv_usec/1000000.0;
+}
+
+int main(int argc,char **argv)
+{
+	BYTE buffer[512];
+	int errors = 0;
+
+	//Fill buffer
+	srand(1234);
+	for (int i=0;i<(int)sizeof(buffer);i++)
+		buffer[i] = rand();
+
+	//Check all lengths and alignments against the references
+	for (int off=0;off<8;off++)
+	{
+		for (int len=0;len<=300;len++)
+		{
+			CRC8 crc8;
+			CRC16 crc16;
+			CRC8 split8;
+			CRC16 split16;
+
+			//Whole buffer
+			crc8.Add(buffer+off,len);
+			crc16.Add(buffer+off,len);
+
+			//Byte and block mixed
+			split8.Add(buffer[off]);
+			split8.Add(buffer+off+1,len/2);
+			split8.Add(buffer+off+1+len/2,len-len/2);
+			split16.Add(buffer[off]);
+			split16.Add(buffer+off+1,len/2);
+			split16.Add(buffer+off+1+len/2,len-len/2);
+
+			//Check
+			if (crc8.Calc()!=crc8_reference(buffer+off,len))
+				errors++;
+			if (crc16.Calc()!=crc16_reference(buffer+off,len))
+				errors++;
+			if (split8.Calc()!=crc8_reference(buffer+off,len+1))
+				errors++;
+			if (split16.Calc()!=crc16_reference(buffer+off,len+1))
+				errors++;
+		}
+	}
+
+	printf("equivalence: %d errors\n",errors);
+
+	//Benchmark the usual sdu sizes
+	int sizes[] = {32,162,261};
+
+	for (int s=0;s<3;s++)
+	{
+		int len = sizes[s];
+		int loops = 2000000;
+		BYTE r8 = 0;
+		WORD r16 = 0;
+
+		//Byte at a time
+		double ini = now();
+		for (int i=0;i<loops;i++)
+		{
+			CRC16 crc;
+			for (int j=0;j<len;j++)
+				crc.Add(buffer[j]);
+			r16 ^= crc.Calc();
+		}
+		double byte16 = now()-ini;
+
+		//Block
+		ini = now();
+		for (int i=0;i<loops;i++)
+		{
+			CRC16 crc;
+			crc.Add(buffer,len);
+			r16 ^= crc.Calc();
+		}
+		double block16 = now()-ini;
+
+		//Byte at a time
+		ini = now();
+		for (int i=0;i<loops;i++)
+		{
+			CRC8 crc;
+			for (int j=0;j<len;j++)
+				crc.Add(buffer[j]);
+			r8 ^= crc.Calc();
+		}
+		double byte8 = now()-ini;
+
+		//Block
+		ini = now();
+		for (int i=0;i<loops;i++)
+		{
+			CRC8 crc;
+			crc.Add(buffer,len);
+			r8 ^= crc.Calc();
+		}
+		double block8 = now()-ini;
+
+		printf("%3d bytes: crc16 %7.1f -> %7.1f MB/s, crc8 %7.1f -> %7.1f MB/s [%x]\n",len,
+			len*loops/byte16/1E6,len*loops/block16/1E6,
+			len*loops/byte8/1E6,len*loops/block8/1E6,r8^r16);
+	}
+
+	return errors!=0;
+}
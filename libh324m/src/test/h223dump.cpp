@@ -1,10 +1,15 @@
 #include "../H223Demuxer.h"
 #include "../H324CCSRLayer.h"
 
+//Pool for the control sdus
+static H223MuxSDUPool pool;
+
 class DumpChannel :
 	public H324CCSRLayer
 {
 public:
+	DumpChannel() : H324CCSRLayer(&pool) {}
+
 	//Method overrides from ccsrl
 	virtual int OnControlPDU(H324ControlPDU &pdu)
 	{
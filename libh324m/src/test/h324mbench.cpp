@@ -0,0 +1,525 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <vector>
+#include "../H223Muxer.h"
+#include "../H223Demuxer.h"
+#include "../H324MAL2.h"
+#include "../crc8.h"
+#include "../crc16.h"
+extern "C" {
+#include "../golay.h"
+}
+#include "../bits.h"
+#include "../TraceBuffer.h"
+
+/**********************************
+* h324mbench
+*	Times the mux, demux, AL2, crc, golay and bit reversal hot paths.
+*	Each result is printed as one JSON object per line so the output of
+*	two releases can be compared with any script:
+*	  {"bench":"demux","input":"synthetic","bytes":N,"ns_per_byte":x,"mbytes_per_s":y}
+*	Captured H.223 streams given as arguments are also demuxed. Raw files
+*	are taken in the bit order of H.223, like the old /tmp/h223_in_*.raw
+*	dumps written after the bits were reversed. Raw files written by
+*	"tracedump file in" are in the bearer order and need -r. The input
+*	records of .trace files are always in the bearer order.
+*	The captures are demuxed with the synthetic mux table, not the one
+*	negotiated in the call, so only their byte throughput is meaningful.
+***********************************/
+
+static H223MuxSDUPool pool;
+static double minTime = 0.5;
+static DWORD seed = 12345;
+
+static DWORD Random()
+{
+	seed = seed*1103515245u+12345u;
+	return (seed>>8)&0xFFFFFF;
+}
+
+static double Now()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC,&ts);
+	return ts.tv_sec + ts.tv_nsec/1E9;
+}
+
+static void Report(const char *bench,const char *input,double bytes,double seconds,double units = 0,const char *unit = NULL)
+{
+	printf("{\"bench\":\"%s\",\"input\":\"%s\",\"bytes\":%.0f,\"seconds\":%.6f,\"ns_per_byte\":%.3f,\"mbytes_per_s\":%.3f",
+		bench,input,bytes,seconds,seconds*1E9/bytes,bytes/seconds/1E6);
+	//If we have other units
+	if (unit)
+		printf(",\"%s\":%.0f,\"ns_per_%s\":%.3f",unit,units,unit,seconds*1E9/units);
+	printf("}\n");
+	fflush(stdout);
+}
+
+//Counts what the demuxer delivers without doing anything else
+class NullReceiver : public H223ALReceiver
+{
+public:
+	NullReceiver() { bytes = 0; }
+	virtual void Send(BYTE b)				{ bytes++; }
+	virtual void Send(const BYTE *buffer,int len)		{ bytes += len; }
+	virtual void SendReversed(const BYTE *buffer,int len)	{ bytes += len; }
+	virtual void SendClosingFlag()				{}
+	virtual int IsSegmentable()				{ return true; }
+	DWORD bytes;
+};
+
+//Counts the sdus of the AL2 receivers
+class NullListener : public H223SDUListener
+{
+public:
+	NullListener() { sdus = 0; }
+	virtual void OnSDU(BYTE* data,DWORD length)		{ sdus++; }
+	DWORD sdus;
+};
+
+static void SetTable(H223MuxTable &table)
+{
+	//Control, audio, video and audio with video entries
+	table.SetEntry(0,"","0");
+	table.SetEntry(1,"","1");
+	table.SetEntry(2,"","2");
+	table.SetEntry(3,"11111111111111111111111111111111","2");
+	table.SetEntry(4,"","12");
+}
+
+/*
+ * Synthetic 64kbps call: an AMR frame each 20ms (160 bytes) and video
+ * filling the rest of the bandwidth, muxed with the given policy.
+ * Returns the time spent muxing and the number of pdus.
+ */
+static double Mux(std::vector<BYTE> &stream,DWORD length,H223Muxer::Policy policy,DWORD *pdus)
+{
+	H223MuxTable table;
+	H223Muxer muxer;
+	H223AL2Sender audio(&pool,false,false);
+	H223AL2Sender video(&pool,true,false);
+	BYTE frame[160];
+	BYTE buffer[160];
+	double spent = 0;
+
+	//Set up
+	SetTable(table);
+	muxer.Open(&table);
+	muxer.SetPolicy(policy);
+	muxer.SetChannel(1,&audio);
+	muxer.SetChannel(2,&video);
+
+	//Random payload
+	for (int i=0;i<160;i++)
+		frame[i] = Random();
+
+	//Clean
+	stream.clear();
+	*pdus = 0;
+
+	//Until done
+	while (stream.size()<length)
+	{
+		//Audio frame
+		audio.SendPDU(frame,32);
+		//Video up to the remaining bandwidth
+		video.SendPDU(frame,128-Random()%16);
+
+		//Mux 20ms
+		double ini = Now();
+		muxer.Multiplex(buffer,160);
+		spent += Now()-ini;
+
+		//Append
+		stream.insert(stream.end(),buffer,buffer+160);
+	}
+
+	//Count pdus by their flags
+	for (DWORD i=0;i+1<stream.size();i++)
+		if (stream[i]==0xE1 && stream[i+1]==0x4D)
+			(*pdus)++;
+
+	//Close
+	muxer.Close();
+
+	return spent;
+}
+
+static void BenchMux()
+{
+	static const char *names[] = {"fillratio","audiofirst","throughput"};
+	std::vector<BYTE> stream;
+
+	//For each policy
+	for (int p=0;p<3;p++)
+	{
+		DWORD pdus = 0;
+		DWORD total = 0;
+		DWORD num = 0;
+		double spent = 0;
+
+		//Repeat until we have enough time
+		while (spent<minTime)
+		{
+			//Mux 1MB
+			spent += Mux(stream,1024*1024,(H223Muxer::Policy)p,&num);
+			total += stream.size();
+			pdus += num;
+		}
+
+		//Each pdu runs GetBestMC once, so per pdu time is dominated by it
+		Report("mux",names[p],total,spent,pdus,"pdu");
+	}
+}
+
+static void Demux(const char *name,std::vector<BYTE> &stream,int reverse,int al2,int chunk)
+{
+	H223MuxTable table;
+	NullListener listener;
+	NullReceiver control;
+	double spent = 0;
+	double total = 0;
+
+	//Set table
+	SetTable(table);
+
+	//Reverse input if needed
+	std::vector<BYTE> input(stream);
+	if (reverse)
+		TIFFReverseBits(&input[0],input.size());
+
+	//Repeat until we have enough time
+	while (spent<minTime)
+	{
+		H223Demuxer demuxer;
+		NullReceiver audio;
+		NullReceiver video;
+		H223AL2Receiver audioAL2(&pool,false,&listener,false);
+		H223AL2Receiver videoAL2(&pool,true,&listener,false);
+
+		//Set channels
+		demuxer.SetChannel(0,&control);
+		if (al2)
+		{
+			demuxer.SetChannel(1,&audioAL2);
+			demuxer.SetChannel(2,&videoAL2);
+		} else {
+			demuxer.SetChannel(1,&audio);
+			demuxer.SetChannel(2,&video);
+		}
+		demuxer.SetReverseBits(reverse);
+		demuxer.Open(&table);
+
+		double ini = Now();
+		//Demux in chunks
+		for (DWORD i=0;i<input.size();i+=chunk)
+			demuxer.Demultiplex(&input[i],i+chunk<input.size() ? chunk : input.size()-i);
+		spent += Now()-ini;
+		total += input.size();
+
+		demuxer.Close();
+	}
+
+	char variant[64];
+	sprintf(variant,"%s%s,chunk=%d",name,reverse?",reversed":"",chunk);
+	Report(al2?"demux_al2":"demux",variant,total,spent);
+}
+
+static void BenchAL2()
+{
+	H223AL2Sender sender(&pool,true,false);
+	BYTE frame[160];
+	double total = 0;
+	double sdus = 0;
+	double spent = 0;
+
+	//Random payload
+	for (int i=0;i<160;i++)
+		frame[i] = Random();
+
+	//Repeat until we have enough time
+	while (spent<minTime)
+	{
+		double ini = Now();
+		//Enqueue and dequeue as the muxer would do
+		for (int i=0;i<10000;i++)
+		{
+			sender.SendPDU(frame,160);
+			if (sender.GetNextPDU())
+				sender.OnPDUCompleted();
+		}
+		spent += Now()-ini;
+		total += 160*10000;
+		sdus += 10000;
+	}
+
+	Report("al2_sendpdu","160",total,spent,sdus,"sdu");
+}
+
+static void BenchCRC()
+{
+	static const int sizes[] = {32,162,261};
+	BYTE buffer[512];
+	DWORD r = 0;
+
+	//Random data
+	for (int i=0;i<512;i++)
+		buffer[i] = Random();
+
+	//For each usual size
+	for (int s=0;s<3;s++)
+	{
+		char input[16];
+		int len = sizes[s];
+		double spent,total,ini;
+
+		sprintf(input,"%d",len);
+
+		//CRC8
+		spent = total = 0;
+		while (spent<minTime)
+		{
+			ini = Now();
+			for (int i=0;i<100000;i++)
+			{
+				CRC8 crc;
+				crc.Add(buffer+(i&7),len);
+				r += crc.Calc();
+			}
+			spent += Now()-ini;
+			total += 100000.0*len;
+		}
+		Report("crc8",input,total,spent);
+
+		//CRC16
+		spent = total = 0;
+		while (spent<minTime)
+		{
+			ini = Now();
+			for (int i=0;i<100000;i++)
+			{
+				CRC16 crc;
+				crc.Add(buffer+(i&7),len);
+				r += crc.Calc();
+			}
+			spent += Now()-ini;
+			total += 100000.0*len;
+		}
+		Report("crc16",input,total,spent);
+	}
+
+	//Don't let the compiler remove it
+	if (r==0xFFFFFFFF)
+		printf("\n");
+}
+
+static void BenchGolay()
+{
+	guint32 codes[4096];
+	DWORD r = 0;
+	double spent = 0;
+	double total = 0;
+
+	//Encode
+	while (spent<minTime)
+	{
+		double ini = Now();
+		for (int i=0;i<4096;i++)
+			codes[i] = golay_encode(i);
+		spent += Now()-ini;
+		total += 4096;
+	}
+	//Each header is 3 bytes
+	Report("golay_encode","header",total*3,spent,total,"header");
+
+	//Flip some bits so it has to correct them
+	for (int i=0;i<4096;i++)
+		codes[i] ^= 1<<(i%24);
+
+	//Decode
+	spent = total = 0;
+	while (spent<minTime)
+	{
+		double ini = Now();
+		for (int i=0;i<4096;i++)
+			r += golay_decode(codes[i]);
+		spent += Now()-ini;
+		total += 4096;
+	}
+	Report("golay_decode","header",total*3,spent,total,"header");
+
+	//Don't let the compiler remove it
+	if (r==0xFFFFFFFF)
+		printf("\n");
+}
+
+static void BenchReverse()
+{
+	static const int sizes[] = {160,4096};
+	BYTE src[4096];
+	BYTE dst[4096];
+
+	//Random data
+	for (int i=0;i<4096;i++)
+		src[i] = Random();
+
+	//For each size
+	for (int s=0;s<2;s++)
+	{
+		char input[16];
+		int len = sizes[s];
+		double spent = 0;
+		double total = 0;
+
+		sprintf(input,"%d",len);
+
+		//In place
+		while (spent<minTime)
+		{
+			double ini = Now();
+			for (int i=0;i<10000;i++)
+				TIFFReverseBits(src,len);
+			spent += Now()-ini;
+			total += 10000.0*len;
+		}
+		Report("reverse",input,total,spent);
+
+		//Copying
+		spent = total = 0;
+		while (spent<minTime)
+		{
+			double ini = Now();
+			for (int i=0;i<10000;i++)
+				TIFFReverseBitsCopy(dst,src,len);
+			spent += Now()-ini;
+			total += 10000.0*len;
+		}
+		Report("reverse_copy",input,total,spent);
+	}
+}
+
+static int IsTrace(const char *name)
+{
+	//Check extension
+	return strlen(name)>6 && strcmp(name+strlen(name)-6,".trace")==0;
+}
+
+static int Load(const char *name,std::vector<BYTE> &stream)
+{
+	BYTE buffer[65536];
+	BYTE header[8];
+	int len;
+
+	//Open file
+	int fd = open(name,O_RDONLY);
+
+	//Check
+	if (fd==-1)
+		return 0;
+
+	//Check if it's a trace file
+	if (IsTrace(name))
+	{
+		//Read records
+		while (read(fd,header,8)==8)
+		{
+			WORD length;
+			//Get length
+			memcpy(&length,header+6,2);
+			//Read data
+			if (read(fd,buffer,length)!=length)
+				break;
+			//Only the bearer input
+			if (header[4]==TraceBuffer::e_Input)
+				stream.insert(stream.end(),buffer,buffer+length);
+		}
+	} else {
+		//Read all
+		while ((len=read(fd,buffer,sizeof(buffer)))>0)
+			stream.insert(stream.end(),buffer,buffer+len);
+	}
+
+	//Close
+	close(fd);
+
+	return stream.size()>0;
+}
+
+int main(int argc,char **argv)
+{
+	std::vector<BYTE> stream;
+	DWORD pdus;
+	int rawReversed = false;
+	int i = 1;
+
+	//Check options
+	for (;i<argc && argv[i][0]=='-';i++)
+	{
+		//Minimum time per bench
+		if (strcmp(argv[i],"-t")==0 && i+1<argc)
+			minTime = atof(argv[++i]);
+		//Raw captures in the bits order of the bearer
+		else if (strcmp(argv[i],"-r")==0)
+			rawReversed = true;
+		else
+			//Wrong
+			minTime = 0;
+	}
+
+	//Check
+	if (minTime<=0)
+	{
+		printf("usage: h324mbench [-t seconds] [-r] [captured h223 streams...]\n");
+		printf("\t-t\tminimum time of each bench, 0.5s by default\n");
+		printf("\t-r\traw captures are in the bit order of the bearer, as written by tracedump\n");
+		printf("\t\tby default they are in the bit order of H.223, .trace files are always bearer order\n");
+		printf("\tcaptures are demuxed with a synthetic mux table, only their byte throughput is meaningful\n");
+		return 1;
+	}
+
+	//Mux
+	BenchMux();
+
+	//Get a 1MB synthetic stream
+	Mux(stream,1024*1024,H223Muxer::e_FillRatio,&pdus);
+
+	//Demux it with the usual chunk sizes
+	Demux("synthetic",stream,false,false,160);
+	Demux("synthetic",stream,false,false,10);
+	Demux("synthetic",stream,true,false,160);
+	Demux("synthetic",stream,false,true,160);
+	Demux("synthetic",stream,true,true,160);
+
+	//Demux the captures
+	for (;i<argc;i++)
+	{
+		std::vector<BYTE> capture;
+		//Trace records are in the bearer order, raw ones as told
+		int reversed = IsTrace(argv[i]) ? true : rawReversed;
+		//Load it
+		if (!Load(argv[i],capture))
+		{
+			fprintf(stderr,"unable to read [%s]\n",argv[i]);
+			continue;
+		}
+		//Put the bits in H.223 order, the demuxer will reverse them back
+		if (reversed)
+			TIFFReverseBits(&capture[0],capture.size());
+		//Demux it as it was captured
+		Demux(argv[i],capture,reversed,true,160);
+	}
+
+	//The rest of hot paths
+	BenchAL2();
+	BenchCRC();
+	BenchGolay();
+	BenchReverse();
+
+	return 0;
+}
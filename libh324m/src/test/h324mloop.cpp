@@ -0,0 +1,357 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include "../H324MSession.h"
+
+/**********************************
+* h324mloop
+*	Runs pairs of sessions connected back to back in memory, the bytes
+*	written by each one are read by the other as a 64kbps bearer would
+*	do. Each pair goes through the whole H.245 call setup (CCSRL, master
+*	slave, capabilities, mux tables and logical channels) and then sends
+*	AMR and H.263 frames both ways for the given call time.
+*
+*	The bearer time is simulated, the sessions run as fast as the cpu
+*	allows, so the cpu used for each second of call gives how many
+*	sessions a core can keep. Each pair is two sessions, as a gateway
+*	has one session per call. The result is printed as a JSON line like
+*	the h324mbench ones.
+***********************************/
+
+#define MAX_FRAMES 32
+
+struct Pair
+{
+	H324MSession*	a;
+	H324MSession*	b;
+	//Bearer ms when both sides were stablished, -1 if not yet
+	int		setup;
+	DWORD		audioSent;
+	DWORD		videoSent;
+	DWORD		audioReceived;
+	DWORD		videoReceived;
+};
+
+struct Worker
+{
+	pthread_t	thread;
+	Pair*		pairs;
+	int		num;
+	//Cpu seconds of each phase
+	double		setupCpu;
+	double		callCpu;
+	//Bearer ms run in the call phase
+	DWORD		callTime;
+};
+
+static int chunk = 160;
+static DWORD callTime = 60000;
+static DWORD setupTimeout = 30000;
+static int audioSize = 31;
+static int videoRate = 40000;
+static int videoFps = 10;
+
+static double CpuTime()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID,&ts);
+	return ts.tv_sec + ts.tv_nsec/1E9;
+}
+
+static void Receive(H324MSession *session,Pair *pair)
+{
+	Frame *frames[MAX_FRAMES];
+	int num;
+
+	//Get all the frames, they must be destroyed in this thread
+	while ((num=session->GetFrames(frames,MAX_FRAMES))>0)
+	{
+		for (int i=0;i<num;i++)
+		{
+			//Count
+			if (frames[i]->type==e_Audio)
+				pair->audioReceived++;
+			else
+				pair->videoReceived++;
+			//Release sdu
+			delete frames[i];
+		}
+	}
+}
+
+static void Send(H324MSession *session,Pair *pair,BYTE *audio,BYTE *video,DWORD ms)
+{
+	Frame *frames[2];
+	int num = 0;
+
+	//AMR frame each 20ms
+	if (ms%20==0)
+	{
+		frames[num++] = new Frame(e_Audio,e_AMR,audio,audioSize,NULL,NULL);
+		pair->audioSent++;
+	}
+
+	//H.263 picture at the frame rate, an intra one each 10s
+	if (ms%(1000/videoFps)==0)
+	{
+		//Picture start code, QCIF and coding type
+		video[4] = 0x08 | (ms%10000 ? 0x02 : 0x00);
+		frames[num++] = new Frame(e_Video,e_H263,video,videoRate/8/videoFps,NULL,NULL);
+		pair->videoSent++;
+	}
+
+	//Nothing to do
+	if (!num)
+		return;
+
+	//Send them, the data is copied to the sdus
+	session->SendFrames(frames,num);
+
+	//Delete
+	for (int i=0;i<num;i++)
+		delete frames[i];
+}
+
+/*
+ * Moves step ms of bearer both ways in a pair and delivers the
+ * received frames. Media is only sent once both sides are stablished.
+ */
+static void Step(Pair *pair,BYTE *ab,BYTE *ba,DWORD ms,DWORD step,BYTE *audio,BYTE *video)
+{
+	//If both are stablished
+	if (pair->setup!=-1)
+	{
+		//Send media scheduled in this step
+		for (DWORD t=ms;t<ms+step;t++)
+		{
+			Send(pair->a,pair,audio,video,t);
+			Send(pair->b,pair,audio,video,t);
+		}
+	}
+
+	//Cross connect
+	pair->a->Write(ab,chunk);
+	pair->b->Write(ba,chunk);
+	pair->b->Read(ab,chunk);
+	pair->a->Read(ba,chunk);
+
+	//Deliver
+	Receive(pair->a,pair);
+	Receive(pair->b,pair);
+
+	//Check if it has just been stablished
+	if (pair->setup==-1 && pair->a->GetState()==H324MSession::e_Stablished && pair->b->GetState()==H324MSession::e_Stablished)
+		//Store the time it took
+		pair->setup = ms+step;
+}
+
+static void* Run(void *arg)
+{
+	Worker *worker = (Worker *)arg;
+	BYTE *ab = (BYTE*)malloc(chunk);
+	BYTE *ba = (BYTE*)malloc(chunk);
+	BYTE *audio = (BYTE*)malloc(audioSize);
+	BYTE *video = (BYTE*)malloc(videoRate/8/videoFps);
+	DWORD step = chunk/8;
+	DWORD ms = 0;
+	int stablished = 0;
+	double ini;
+
+	//Payloads
+	for (int i=0;i<audioSize;i++)
+		audio[i] = 0x3C ^ i;
+	for (int i=0;i<videoRate/8/videoFps;i++)
+		video[i] = 0x55 ^ (i*7);
+
+	//H.263 picture start code
+	video[0] = 0x00;
+	video[1] = 0x00;
+	video[2] = 0x80;
+	video[3] = 0x02;
+
+	//Start setup
+	ini = CpuTime();
+
+	//Init all sessions
+	for (int i=0;i<worker->num;i++)
+	{
+		worker->pairs[i].a->Init();
+		worker->pairs[i].b->Init();
+	}
+
+	//Until all are stablished or timeout
+	while (stablished<worker->num && ms<setupTimeout)
+	{
+		//Reset
+		stablished = 0;
+		//Step each pair
+		for (int i=0;i<worker->num;i++)
+		{
+			//Run
+			Step(&worker->pairs[i],ab,ba,ms,step,audio,video);
+			//Count
+			if (worker->pairs[i].setup!=-1)
+				stablished++;
+		}
+		//Next
+		ms += step;
+	}
+
+	//Setup done
+	worker->setupCpu = CpuTime()-ini;
+
+	//Start call
+	ini = CpuTime();
+
+	//Run the call time
+	for (DWORD end=ms+callTime;ms<end;ms+=step)
+		for (int i=0;i<worker->num;i++)
+			Step(&worker->pairs[i],ab,ba,ms,step,audio,video);
+
+	//Call done
+	worker->callCpu = CpuTime()-ini;
+	worker->callTime = callTime;
+
+	//Hang up and let the release go through for one second
+	for (int i=0;i<worker->num;i++)
+	{
+		worker->pairs[i].a->End();
+		worker->pairs[i].b->End();
+	}
+	for (DWORD end=ms+1000;ms<end;ms+=step)
+		for (int i=0;i<worker->num;i++)
+			Step(&worker->pairs[i],ab,ba,ms,step,audio,video);
+
+	//Free
+	free(ab);
+	free(ba);
+	free(audio);
+	free(video);
+
+	return NULL;
+}
+
+int main(int argc,char **argv)
+{
+	int numPairs = 16;
+	int numWorkers = 1;
+	int ok = true;
+
+	//Check options
+	for (int i=1;i<argc;i++)
+	{
+		//Number of pairs
+		if (strcmp(argv[i],"-p")==0 && i+1<argc)
+			numPairs = atoi(argv[++i]);
+		//Number of threads
+		else if (strcmp(argv[i],"-w")==0 && i+1<argc)
+			numWorkers = atoi(argv[++i]);
+		//Call time
+		else if (strcmp(argv[i],"-s")==0 && i+1<argc)
+			callTime = atoi(argv[++i])*1000;
+		//Bytes moved each step
+		else if (strcmp(argv[i],"-c")==0 && i+1<argc)
+			chunk = atoi(argv[++i]);
+		else
+			//Wrong
+			ok = false;
+	}
+
+	//Check
+	if (!ok || numPairs<=0 || numWorkers<=0 || numWorkers>numPairs || callTime==0 || chunk<8 || chunk%8)
+	{
+		printf("usage: h324mloop [-p pairs] [-w threads] [-s seconds] [-c chunk]\n");
+		printf("\t-p\tsession pairs, 16 by default\n");
+		printf("\t-w\tthreads sharing the pairs, 1 by default\n");
+		printf("\t-s\tcall time after setup, 60s by default\n");
+		printf("\t-c\tbearer bytes moved each step, multiple of 8 (1ms), 160 by default\n");
+		return 1;
+	}
+
+	//Create pairs
+	Pair *pairs = (Pair*)malloc(numPairs*sizeof(Pair));
+	for (int i=0;i<numPairs;i++)
+	{
+		pairs[i].a = new H324MSession();
+		pairs[i].b = new H324MSession();
+		pairs[i].setup = -1;
+		pairs[i].audioSent = 0;
+		pairs[i].videoSent = 0;
+		pairs[i].audioReceived = 0;
+		pairs[i].videoReceived = 0;
+	}
+
+	//Split them between the workers
+	Worker *workers = (Worker*)malloc(numWorkers*sizeof(Worker));
+	for (int i=0,first=0;i<numWorkers;i++)
+	{
+		workers[i].pairs = pairs+first;
+		workers[i].num = numPairs/numWorkers + (i<numPairs%numWorkers);
+		first += workers[i].num;
+	}
+
+	//Launch
+	for (int i=0;i<numWorkers;i++)
+		pthread_create(&workers[i].thread,NULL,Run,&workers[i]);
+
+	//Wait
+	for (int i=0;i<numWorkers;i++)
+		pthread_join(workers[i].thread,NULL);
+
+	//Sum
+	double setupCpu = 0;
+	double callCpu = 0;
+	double callSeconds = 0;
+	for (int i=0;i<numWorkers;i++)
+	{
+		setupCpu += workers[i].setupCpu;
+		callCpu += workers[i].callCpu;
+		callSeconds += workers[i].callTime/1000.0*workers[i].num*2;
+	}
+
+	int stablished = 0;
+	int setupMax = 0;
+	double setupSum = 0;
+	DWORD audioSent = 0,audioReceived = 0,videoSent = 0,videoReceived = 0;
+	for (int i=0;i<numPairs;i++)
+	{
+		//If it was stablished
+		if (pairs[i].setup!=-1)
+		{
+			stablished++;
+			setupSum += pairs[i].setup;
+			if (pairs[i].setup>setupMax)
+				setupMax = pairs[i].setup;
+		}
+		audioSent += pairs[i].audioSent;
+		audioReceived += pairs[i].audioReceived;
+		videoSent += pairs[i].videoSent;
+		videoReceived += pairs[i].videoReceived;
+	}
+
+	//Cpu seconds used by each second of one session
+	double load = callCpu/callSeconds;
+
+	printf("{\"bench\":\"loopback\",\"pairs\":%d,\"threads\":%d,\"chunk\":%d,\"stablished\":%d,"
+		"\"setup_ms_avg\":%.1f,\"setup_ms_max\":%d,\"setup_cpu_ms_per_session\":%.3f,"
+		"\"call_seconds\":%.0f,\"cpu_seconds\":%.3f,\"cpu_ms_per_call_second\":%.4f,\"sessions_per_core\":%.0f,"
+		"\"audio_sent\":%u,\"audio_received\":%u,\"video_sent\":%u,\"video_received\":%u}\n",
+		numPairs,numWorkers,chunk,stablished,
+		stablished ? setupSum/stablished : 0.0,setupMax,setupCpu*1000/(numPairs*2),
+		callSeconds,callCpu,load*1000,load>0 ? 1/load : 0.0,
+		audioSent,audioReceived,videoSent,videoReceived);
+
+	//Delete sessions
+	for (int i=0;i<numPairs;i++)
+	{
+		delete pairs[i].a;
+		delete pairs[i].b;
+	}
+	free(pairs);
+	free(workers);
+
+	//Fail if any call was not stablished
+	return stablished==numPairs ? 0 : 2;
+}
@@ -0,0 +1,355 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <dirent.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <vector>
+#include <string>
+#include "../H324MSession.h"
+
+/**********************************
+* h324mreplay
+*	Replays captured calls through sessions, in parallel, to reproduce
+*	offline the cpu used by real calls. The captures are the bearer
+*	input of a session, either the session trace files, from which the
+*	input records are taken, or raw files. The trace records are in the
+*	bit order of the bearer. The raw files are taken in the bit order of
+*	H.223, as the old /tmp/h223_in_*.raw dumps were written after the
+*	bits were reversed. Raw files written by "tracedump file in" are in
+*	the bearer order and need -r.
+*
+*	Each capture is read into memory and fed to its own session chunk
+*	bytes at a time, muxing the same amount back and taking the frames
+*	as app_h324m does. The session profiler splits the time among the
+*	demux, AL, control and frame extraction stages. One JSON line is
+*	printed for each capture and a last one with the totals.
+***********************************/
+
+#define MAX_FRAMES 32
+
+struct Capture
+{
+	std::string		name;
+	std::vector<BYTE>	data;
+	//Bits as read from the bearer
+	int			reversed;
+	//Results
+	double			cpu;
+	unsigned long long	time[Profiler::e_NumStages];
+	DWORD			frames;
+	int			state;
+};
+
+static std::vector<Capture*> captures;
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+static unsigned int nextCapture = 0;
+static int chunk = 160;
+static int rawReversed = false;
+
+static double CpuTime()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID,&ts);
+	return ts.tv_sec + ts.tv_nsec/1E9;
+}
+
+static int ReadAll(int fd,BYTE *buffer,int len)
+{
+	int pos = 0;
+
+	//Read until all or end of file
+	while (pos<len)
+	{
+		//Read
+		int n = read(fd,buffer+pos,len-pos);
+		//Check end
+		if (n<=0)
+			return pos;
+		//Increase
+		pos += n;
+	}
+
+	return pos;
+}
+
+static int Load(const char *name)
+{
+	BYTE header[8];
+	BYTE data[65536];
+	int len;
+
+	//Open file
+	int fd = open(name,O_RDONLY);
+
+	//Check
+	if (fd==-1)
+	{
+		printf("unable to open [%s]\n",name);
+		return 0;
+	}
+
+	//Create capture
+	Capture *capture = new Capture();
+	capture->name = name;
+	capture->cpu = 0;
+	capture->frames = 0;
+	capture->state = 0;
+	//Raw dumps are in H.223 order unless told otherwise
+	capture->reversed = rawReversed;
+
+	//Check if it's a trace file
+	if (strlen(name)>6 && strcmp(name+strlen(name)-6,".trace")==0)
+	{
+		//Trace records are in the bearer order
+		capture->reversed = true;
+		//Read records
+		while (ReadAll(fd,header,8)==8)
+		{
+			WORD length;
+			//Get length
+			memcpy(&length,header+6,2);
+			//Read data
+			if (ReadAll(fd,data,length)!=length)
+				break;
+			//Only the bearer input
+			if (header[4]==TraceBuffer::e_Input)
+				capture->data.insert(capture->data.end(),data,data+length);
+		}
+	} else {
+		//Raw bytes
+		while ((len=ReadAll(fd,data,sizeof(data)))>0)
+			capture->data.insert(capture->data.end(),data,data+len);
+	}
+
+	//Close
+	close(fd);
+
+	//Skip empty ones
+	if (capture->data.empty())
+	{
+		delete capture;
+		return 0;
+	}
+
+	//Add it
+	captures.push_back(capture);
+
+	return 1;
+}
+
+static void Replay(Capture *capture)
+{
+	H324MSession *session = new H324MSession();
+	Frame *frames[MAX_FRAMES];
+	BYTE *output = (BYTE*)malloc(chunk);
+	DWORD length = capture->data.size();
+	int num;
+
+	//Configure
+	session->SetReverseBits(capture->reversed);
+	session->GetProfiler()->SetEnabled(true);
+
+	//Start
+	double ini = CpuTime();
+
+	//Init session
+	session->Init();
+
+	//Feed it
+	for (DWORD pos=0;pos<length;pos+=chunk)
+	{
+		//Length of this chunk
+		int len = (length-pos>(DWORD)chunk) ? chunk : length-pos;
+		//Demux
+		session->Read(&capture->data[pos],len);
+		//Get frames, they are not sent back
+		while ((num=session->GetFrames(frames,MAX_FRAMES))>0)
+		{
+			//Count
+			capture->frames += num;
+			//Destroy
+			for (int i=0;i<num;i++)
+				delete frames[i];
+		}
+		//Mux the same amount
+		session->Write(output,len);
+	}
+
+	//Get state before ending
+	capture->state = session->GetState();
+
+	//End
+	session->End();
+
+	//Done
+	capture->cpu = CpuTime()-ini;
+
+	//Get stages
+	for (int i=0;i<Profiler::e_NumStages;i++)
+		capture->time[i] = session->GetProfiler()->GetTime((Profiler::Stage)i);
+
+	//Delete
+	delete session;
+	free(output);
+}
+
+static void* Run(void *arg)
+{
+	//Until no more captures
+	while (1)
+	{
+		Capture *capture = NULL;
+
+		//Get next one
+		pthread_mutex_lock(&mutex);
+		if (nextCapture<captures.size())
+			capture = captures[nextCapture++];
+		pthread_mutex_unlock(&mutex);
+
+		//If no more
+		if (!capture)
+			break;
+
+		//Replay it
+		Replay(capture);
+	}
+
+	return NULL;
+}
+
+static void Report(const char *name,DWORD bytes,double cpu,unsigned long long *time,DWORD frames,int state)
+{
+	double stages = 0;
+
+	printf("{\"capture\":\"%s\",\"bytes\":%u,\"call_seconds\":%.3f,\"cpu_seconds\":%.6f",name,bytes,bytes/8000.0,cpu);
+	//Each stage but the time outside the session
+	for (int i=Profiler::e_Idle+1;i<Profiler::e_NumStages;i++)
+	{
+		printf(",\"%s_seconds\":%.6f",Profiler::GetName((Profiler::Stage)i),time[i]/1E9);
+		stages += time[i]/1E9;
+	}
+	//Whatever is not in a stage, including this tool
+	printf(",\"other_seconds\":%.6f,\"frames\":%u",cpu>stages ? cpu-stages : 0.0,frames);
+	//State if it's one capture
+	if (state!=-1)
+		printf(",\"state\":%d",state);
+	printf("}\n");
+}
+
+int main(int argc,char **argv)
+{
+	int numWorkers = 1;
+	int ok = true;
+	int i = 1;
+
+	//Check options
+	for (;i<argc && argv[i][0]=='-';i++)
+	{
+		//Bytes fed each time
+		if (strcmp(argv[i],"-c")==0 && i+1<argc)
+			chunk = atoi(argv[++i]);
+		//Number of threads
+		else if (strcmp(argv[i],"-w")==0 && i+1<argc)
+			numWorkers = atoi(argv[++i]);
+		//Raw captures in the bits order of the bearer
+		else if (strcmp(argv[i],"-r")==0)
+			rawReversed = true;
+		else
+			//Wrong
+			ok = false;
+	}
+
+	//Check
+	if (!ok || i==argc || chunk<=0 || numWorkers<=0)
+	{
+		printf("usage: h324mreplay [-c chunk] [-w threads] [-r] <capture dir or files...>\n");
+		printf("\t-c\tbytes fed to the session each time, 160 by default\n");
+		printf("\t-w\tthreads replaying captures in parallel, 1 by default\n");
+		printf("\t-r\t.raw captures are in the bit order of the bearer, as written by tracedump\n");
+		printf("\t\tby default they are in the bit order of H.223, .trace files are always bearer order\n");
+		printf("\tdirectories are searched for *.raw and *.trace files\n");
+		return 1;
+	}
+
+	//Load all captures
+	for (;i<argc;i++)
+	{
+		DIR *dir = opendir(argv[i]);
+
+		//If it's a file
+		if (!dir)
+		{
+			//Load it
+			Load(argv[i]);
+			continue;
+		}
+
+		struct dirent *entry;
+
+		//Load all the captures in it
+		while ((entry=readdir(dir))!=NULL)
+		{
+			int len = strlen(entry->d_name);
+			//Check extension
+			if ((len>4 && strcmp(entry->d_name+len-4,".raw")==0) || (len>6 && strcmp(entry->d_name+len-6,".trace")==0))
+				Load((std::string(argv[i])+"/"+entry->d_name).c_str());
+		}
+
+		//Close
+		closedir(dir);
+	}
+
+	//Check
+	if (captures.empty())
+	{
+		printf("no captures found\n");
+		return 2;
+	}
+
+	//Launch
+	pthread_t *threads = (pthread_t*)malloc(numWorkers*sizeof(pthread_t));
+	for (int j=0;j<numWorkers;j++)
+		pthread_create(&threads[j],NULL,Run,NULL);
+
+	//Wait
+	for (int j=0;j<numWorkers;j++)
+		pthread_join(threads[j],NULL);
+
+	free(threads);
+
+	//Totals
+	unsigned long long total[Profiler::e_NumStages];
+	DWORD bytes = 0;
+	DWORD frames = 0;
+	double cpu = 0;
+
+	//Clean
+	for (int j=0;j<Profiler::e_NumStages;j++)
+		total[j] = 0;
+
+	//Report each one
+	for (unsigned int j=0;j<captures.size();j++)
+	{
+		Capture *capture = captures[j];
+		//Report
+		Report(capture->name.c_str(),capture->data.size(),capture->cpu,capture->time,capture->frames,capture->state);
+		//Sum
+		bytes += capture->data.size();
+		frames += capture->frames;
+		cpu += capture->cpu;
+		for (int k=0;k<Profiler::e_NumStages;k++)
+			total[k] += capture->time[k];
+		//Delete
+		delete capture;
+	}
+
+	//Report totals
+	Report("total",bytes,cpu,total,frames,-1);
+
+	return 0;
+}
@@ -4,7 +4,7 @@
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <unistd.h>
-#include "../../bits.c"
+#include "../bits.c"
 
 int main(int argc, char** argv) 
 {
@@ -0,0 +1,122 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "../TraceBuffer.h"
+
+static const char* names[] = {"","mux","muxinfo","demux","demuxinfo","mediain","mediaout","in","out","h245in","h245out","h245"};
+
+static int readAll(int fd,BYTE *buffer,int len)
+{
+	int pos = 0;
+
+	//Read until all or end of file
+	while (pos<len)
+	{
+		//Read
+		int n = read(fd,buffer+pos,len-pos);
+		//Check end
+		if (n<=0)
+			return pos;
+		//Increase
+		pos += n;
+	}
+
+	return pos;
+}
+
+int main(int argc,char **argv)
+{
+	BYTE header[8];
+	BYTE data[65536];
+	int raw = 0;
+
+	// Check number of parameters
+	if (argc<2)
+	{
+		printf("usage: tracedump <tracefile> [in|out|mediain|mediaout]\n");
+		printf("       with a type it writes the raw data of those records to stdout\n");
+		return 1;
+	}
+
+	//If we have to extract raw data
+	if (argc>2)
+	{
+		//Find type
+		for (int i=TraceBuffer::e_MediaInput;i<=TraceBuffer::e_Output;i++)
+			if (strcmp(argv[2],names[i])==0)
+				raw = i;
+		//Check
+		if (!raw)
+		{
+			printf("unknown type [%s]\n",argv[2]);
+			return 1;
+		}
+	}
+
+	//Open file
+	int f = open(argv[1],O_RDONLY);
+
+	//Check
+	if (f==-1)
+	{
+		printf("unable to open [%s]\n",argv[1]);
+		return 2;
+	}
+
+	//Read records
+	while (readAll(f,header,8)==8)
+	{
+		DWORD source;
+		WORD length;
+
+		//Get header
+		memcpy(&source,header,4);
+		memcpy(&length,header+6,2);
+		BYTE type = header[4];
+		signed char extra = header[5];
+
+		//Read data
+		if (readAll(f,data,length)!=length)
+			break;
+
+		//If extracting
+		if (raw)
+		{
+			//Only the ones requested
+			if (type==raw)
+				fwrite(data,1,length,stdout);
+			continue;
+		}
+
+		//Print header
+		printf("%.8X %-9s %5d ",source,type<=TraceBuffer::e_H245Event?names[type]:"?",length);
+
+		//Depending on the type
+		switch(type)
+		{
+			case TraceBuffer::e_MuxInfo:
+			case TraceBuffer::e_H245Input:
+			case TraceBuffer::e_H245Output:
+			case TraceBuffer::e_H245Event:
+				printf("%.*s\n",length,data);
+				break;
+			case TraceBuffer::e_DemuxInfo:
+				printf("[%d] %.*s\n",extra,length,data);
+				break;
+			default:
+				//Print bytes
+				for (int i=0;i<length;i++)
+					printf("%s%.2X",(i%32==0 && i)?"\n                         ":" ",data[i]);
+				printf("\n");
+		}
+	}
+
+	//Close
+	close(f);
+
+	return 0;
+}